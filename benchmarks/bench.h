@@ -0,0 +1,282 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+
+#include "../common/csr_graph.h"
+
+// Shared harness for the benchmark drivers: seeded graph generators, a
+// monotonic clock and a runner that measures every (method, generator,
+// size) case in a forked child, so each CSV row reports that case's own
+// peak RSS. Rows are written to stdout as
+//
+//     problem,method,generator,vertices,edges,reps,seconds,edges_per_sec,peak_rss_kb
+//
+// where seconds is the mean wall time of one call of the method.
+
+// Synthetic graph families
+typedef enum BenchGenerator {
+    BENCH_GNM,          // G(n, m): m uniform random edges over n = m / 8 vertices
+    BENCH_GRID,         // Square 2D mesh with 4-neighbour edges
+    BENCH_COMPLETE,     // Complete graph with about m edges
+    BENCH_POWER_LAW,    // Preferential attachment, 4 edges per new vertex
+    BENCH_NEAR_TREE,    // Random tree plus m / 100 extra edges
+    BENCH_GENERATOR_COUNT
+} BenchGenerator;
+
+typedef struct BenchGraph {
+    int V;
+    int E;
+    GraphEdge* edges;
+} BenchGraph;
+
+// One timed method: runs reps calls on graph g and returns the seconds
+// spent inside the calls, excluding any per-call setup
+typedef struct BenchMethod {
+    const char* name;
+    double (*run)(const BenchGraph* g, int reps, uint64_t seed);
+} BenchMethod;
+
+typedef struct BenchOptions {
+    long minEdges;
+    long maxEdges;
+    int reps;
+    uint64_t seed;
+    bool header;
+} BenchOptions;
+
+static inline const char* benchGeneratorName(BenchGenerator gen) {
+    static const char* names[] = {"gnm", "grid", "complete", "power_law", "near_tree"};
+    return names[gen];
+}
+
+// splitmix64: a small, seedable generator with good statistical quality
+static inline uint64_t benchRandom(uint64_t* state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Uniform integer in [0, n)
+static inline int benchRandomBelow(uint64_t* state, long n) {
+    return (int)(benchRandom(state) % (uint64_t)n);
+}
+
+static inline int benchRandomWeight(uint64_t* state) {
+    return 1 + benchRandomBelow(state, 1000000);
+}
+
+static inline double benchNow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static inline void benchAddEdge(BenchGraph* g, int u, int v, uint64_t* state) {
+    g->edges[g->E].src = u;
+    g->edges[g->E].dest = v;
+    g->edges[g->E].weight = benchRandomWeight(state);
+    g->E++;
+}
+
+// Generate a graph of the given family with roughly targetEdges edges
+static inline BenchGraph benchGenerate(BenchGenerator gen, long targetEdges, uint64_t seed) {
+    BenchGraph g = {0, 0, NULL};
+    uint64_t state = seed;
+    long m = targetEdges > 1 ? targetEdges : 1;
+
+    switch (gen) {
+    case BENCH_GNM: {
+        g.V = m / 8 > 2 ? (int)(m / 8) : 2;
+        g.edges = (GraphEdge*)malloc(m * sizeof(GraphEdge));
+        while (g.E < m) {
+            int u = benchRandomBelow(&state, g.V);
+            int v = benchRandomBelow(&state, g.V);
+            if (u != v)
+                benchAddEdge(&g, u, v, &state);
+        }
+        break;
+    }
+    case BENCH_GRID: {
+        int side = (int)sqrt(m / 2.0) + 1;
+        g.V = side * side;
+        g.edges = (GraphEdge*)malloc(2 * (size_t)side * side * sizeof(GraphEdge));
+        for (int r = 0; r < side; r++) {
+            for (int c = 0; c < side; c++) {
+                int v = r * side + c;
+                if (c + 1 < side) benchAddEdge(&g, v, v + 1, &state);
+                if (r + 1 < side) benchAddEdge(&g, v, v + side, &state);
+            }
+        }
+        break;
+    }
+    case BENCH_COMPLETE: {
+        g.V = (int)((1 + sqrt(1 + 8.0 * m)) / 2);
+        if (g.V < 2) g.V = 2;
+        g.edges = (GraphEdge*)malloc((size_t)g.V * (g.V - 1) / 2 * sizeof(GraphEdge));
+        for (int u = 0; u < g.V; u++)
+            for (int v = u + 1; v < g.V; v++)
+                benchAddEdge(&g, u, v, &state);
+        break;
+    }
+    case BENCH_POWER_LAW: {
+        // Each new vertex picks 4 targets with probability proportional to
+        // degree, by sampling endpoints of the edges placed so far
+        const int k = 4;
+        g.V = m / k > k + 1 ? (int)(m / k) : k + 1;
+        g.edges = (GraphEdge*)malloc(((size_t)g.V * k) * sizeof(GraphEdge));
+        for (int u = 0; u <= k; u++)
+            for (int v = u + 1; v <= k; v++)
+                benchAddEdge(&g, u, v, &state);
+        for (int u = k + 1; u < g.V; u++) {
+            int placed = g.E;
+            for (int j = 0; j < k; j++) {
+                GraphEdge e = g.edges[benchRandomBelow(&state, placed)];
+                benchAddEdge(&g, u, benchRandom(&state) & 1 ? e.src : e.dest, &state);
+            }
+        }
+        break;
+    }
+    case BENCH_NEAR_TREE: {
+        long extra = m / 100 > 1 ? m / 100 : 1;
+        g.V = (int)(m - extra + 1);
+        if (g.V < 2) g.V = 2;
+        g.edges = (GraphEdge*)malloc((g.V - 1 + extra) * sizeof(GraphEdge));
+        for (int v = 1; v < g.V; v++)
+            benchAddEdge(&g, benchRandomBelow(&state, v), v, &state);
+        for (long i = 0; i < extra; i++) {
+            int u = benchRandomBelow(&state, g.V);
+            int v = benchRandomBelow(&state, g.V);
+            if (u == v) v = (v + 1) % g.V;
+            benchAddEdge(&g, u, v, &state);
+        }
+        break;
+    }
+    default:
+        break;
+    }
+    return g;
+}
+
+static inline void benchFreeGraph(BenchGraph* g) {
+    free(g->edges);
+    g->edges = NULL;
+    g->V = g->E = 0;
+}
+
+// Parse --min-edges, --max-edges, --reps, --seed and --no-header
+static inline bool benchParseArgs(int argc, char** argv, BenchOptions* opts) {
+    opts->minEdges = 1000;
+    opts->maxEdges = 10000000;
+    opts->reps = 3;
+    opts->seed = 3050;
+    opts->header = true;
+    for (int i = 1; i < argc; i++) {
+        const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(argv[i], "--no-header") == 0) {
+            opts->header = false;
+        } else if (strcmp(argv[i], "--min-edges") == 0 && value) {
+            opts->minEdges = atol(value); i++;
+        } else if (strcmp(argv[i], "--max-edges") == 0 && value) {
+            opts->maxEdges = atol(value); i++;
+        } else if (strcmp(argv[i], "--reps") == 0 && value) {
+            opts->reps = atoi(value); i++;
+        } else if (strcmp(argv[i], "--seed") == 0 && value) {
+            opts->seed = strtoull(value, NULL, 10); i++;
+        } else {
+            fprintf(stderr, "Usage: %s [--min-edges n] [--max-edges n] [--reps n] [--seed n] [--no-header]\n", argv[0]);
+            return false;
+        }
+    }
+    if (opts->reps < 1) opts->reps = 1;
+    if (opts->minEdges < 1) opts->minEdges = 1;
+    return true;
+}
+
+// Run one case in a child process. The child generates the graph, silences
+// the method's own output and sends back the timed seconds; the parent
+// reads the child's peak RSS from wait4.
+static inline bool benchRunCase(const BenchMethod* method, BenchGenerator gen, long targetEdges,
+                                const BenchOptions* opts, int* V, int* E, double* seconds, long* peakKb) {
+    int fds[2];
+    if (pipe(fds) != 0)
+        return false;
+    fflush(stdout);
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        if (!freopen("/dev/null", "w", stdout))
+            _exit(1);
+        uint64_t seed = opts->seed ^ ((uint64_t)gen << 56) ^ (uint64_t)targetEdges;
+        BenchGraph g = benchGenerate(gen, targetEdges, seed);
+        double result[3] = {g.V, g.E, method->run(&g, opts->reps, seed)};
+        benchFreeGraph(&g);
+        ssize_t written = write(fds[1], result, sizeof(result));
+        _exit(written == (ssize_t)sizeof(result) ? 0 : 1);
+    }
+
+    close(fds[1]);
+    double result[3];
+    ssize_t got = read(fds[0], result, sizeof(result));
+    close(fds[0]);
+    int status;
+    struct rusage usage;
+    if (wait4(pid, &status, 0, &usage) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0 ||
+        got != (ssize_t)sizeof(result))
+        return false;
+
+    *V = (int)result[0];
+    *E = (int)result[1];
+    *seconds = result[2] / opts->reps;
+    *peakKb = usage.ru_maxrss;
+    return true;
+}
+
+// Run every method on every generator for edge counts minEdges, 10 x
+// minEdges, ... up to maxEdges, printing one CSV row per case
+static inline int benchRunAll(const char* problem, const BenchMethod* methods, int methodCount,
+                              const BenchOptions* opts) {
+    if (opts->header)
+        printf("problem,method,generator,vertices,edges,reps,seconds,edges_per_sec,peak_rss_kb\n");
+
+    int failures = 0;
+    for (long m = opts->minEdges; m <= opts->maxEdges; m *= 10) {
+        for (int gen = 0; gen < BENCH_GENERATOR_COUNT; gen++) {
+            for (int i = 0; i < methodCount; i++) {
+                int V, E;
+                double seconds;
+                long peakKb;
+                if (!benchRunCase(&methods[i], (BenchGenerator)gen, m, opts, &V, &E, &seconds, &peakKb)) {
+                    fprintf(stderr, "%s/%s failed on %s with %ld edges\n",
+                            problem, methods[i].name, benchGeneratorName((BenchGenerator)gen), m);
+                    failures++;
+                    continue;
+                }
+                printf("%s,%s,%s,%d,%d,%d,%.9f,%.0f,%ld\n", problem, methods[i].name,
+                       benchGeneratorName((BenchGenerator)gen), V, E, opts->reps, seconds,
+                       seconds > 0 ? E / seconds : 0.0, peakKb);
+                fflush(stdout);
+            }
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}
+
+#endif // BENCH_H
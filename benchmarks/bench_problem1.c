@@ -0,0 +1,34 @@
+#define MST_LIBRARY_ONLY
+#include "../problem1_update_mst/main.c"
+#include "bench.h"
+
+// One findBestEdge call per vertex, each treating that vertex as the new
+// one and every other vertex as part of the MST: a full pass over the arcs
+static double benchFindBestEdge(const BenchGraph* g, int reps, uint64_t seed) {
+    (void)seed;
+    CSRGraph* graph = buildCSRGraph(g->V, g->edges, g->E);
+    double total = 0;
+    long long checksum = 0;
+    for (int r = 0; r < reps; r++) {
+        double start = benchNow();
+        for (int v = 0; v < g->V; v++) {
+            int toNode, weight;
+            if (findBestEdge(g->V, graph, v, &toNode, &weight))
+                checksum += weight;
+        }
+        total += benchNow() - start;
+    }
+    printf("%lld\n", checksum);
+    freeCSRGraph(graph);
+    return total;
+}
+
+int main(int argc, char** argv) {
+    BenchOptions opts;
+    if (!benchParseArgs(argc, argv, &opts))
+        return 2;
+    const BenchMethod methods[] = {
+        {"findBestEdge", benchFindBestEdge},
+    };
+    return benchRunAll("problem1", methods, sizeof(methods) / sizeof(methods[0]), &opts);
+}
@@ -0,0 +1,70 @@
+#define MST_LIBRARY_ONLY
+#include "../problem2_prim_kruskal_order/main.c"
+#include "bench.h"
+
+// The edge-list engines sort or reorder their input, so every call gets a
+// fresh copy made outside the timed region
+typedef EdgeOrder* (*EdgeListEngine)(Graph* graph, int* mstSize);
+
+static double benchEdgeListEngine(const BenchGraph* g, int reps, EdgeListEngine engine) {
+    Graph* graph = createGraph(g->V, g->E);
+    double total = 0;
+    for (int r = 0; r < reps; r++) {
+        memcpy(graph->edges, g->edges, (size_t)g->E * sizeof(GraphEdge));
+        int mstSize;
+        double start = benchNow();
+        EdgeOrder* order = engine(graph, &mstSize);
+        total += benchNow() - start;
+        free(order);
+    }
+    free(graph->edges);
+    free(graph);
+    return total;
+}
+
+static EdgeOrder* boruvkaAllThreads(Graph* graph, int* mstSize) {
+    return boruvkaMST(graph, mstSize, 0);
+}
+
+static double benchKruskal(const BenchGraph* g, int reps, uint64_t seed) {
+    (void)seed;
+    return benchEdgeListEngine(g, reps, kruskalMST);
+}
+
+static double benchFilterKruskal(const BenchGraph* g, int reps, uint64_t seed) {
+    (void)seed;
+    return benchEdgeListEngine(g, reps, filterKruskalMST);
+}
+
+static double benchBoruvka(const BenchGraph* g, int reps, uint64_t seed) {
+    (void)seed;
+    return benchEdgeListEngine(g, reps, boruvkaAllThreads);
+}
+
+static double benchPrim(const BenchGraph* g, int reps, uint64_t seed) {
+    (void)seed;
+    CSRGraph* graph = buildCSRGraph(g->V, g->edges, g->E);
+    double total = 0;
+    for (int r = 0; r < reps; r++) {
+        int mstSize;
+        double start = benchNow();
+        EdgeOrder* order = primMST(graph, &mstSize);
+        total += benchNow() - start;
+        free(order);
+    }
+    freeCSRGraph(graph);
+    return total;
+}
+
+int main(int argc, char** argv) {
+    BenchOptions opts;
+    if (!benchParseArgs(argc, argv, &opts))
+        return 2;
+    const BenchMethod methods[] = {
+        {"kruskalMST", benchKruskal},
+        {"filterKruskalMST", benchFilterKruskal},
+        {"boruvkaMST", benchBoruvka},
+        {"primMST", benchPrim},
+    };
+    return benchRunAll("problem2", methods, sizeof(methods) / sizeof(methods[0]), &opts);
+}
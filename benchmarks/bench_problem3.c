@@ -0,0 +1,71 @@
+#define MST_LIBRARY_ONLY
+#include "../problem3_edge_in_mst/main.c"
+#include "bench.h"
+
+// Every call asks about a different edge of the graph, picked from the seed
+typedef bool (*EdgeQueryMethod)(const CSRGraph* graph, int u, int v);
+
+static double benchEdgeQuery(const BenchGraph* g, int reps, uint64_t seed, EdgeQueryMethod method) {
+    CSRGraph* graph = buildCSRGraph(g->V, g->edges, g->E);
+    double total = 0;
+    int inMST = 0;
+    for (int r = 0; r < reps; r++) {
+        const GraphEdge* e = &g->edges[benchRandomBelow(&seed, g->E)];
+        double start = benchNow();
+        inMST += method(graph, e->src, e->dest);
+        total += benchNow() - start;
+    }
+    printf("%d\n", inMST);
+    freeCSRGraph(graph);
+    return total;
+}
+
+static double benchKruskalQuery(const BenchGraph* g, int reps, uint64_t seed) {
+    return benchEdgeQuery(g, reps, seed, isEdgeInMST_Kruskal);
+}
+
+static double benchCycleQuery(const BenchGraph* g, int reps, uint64_t seed) {
+    return benchEdgeQuery(g, reps, seed, isEdgeInMST_CycleProperty);
+}
+
+static double benchPrimQuery(const BenchGraph* g, int reps, uint64_t seed) {
+    return benchEdgeQuery(g, reps, seed, isEdgeInMST_Prim);
+}
+
+// Build the MST index and classify every edge of the graph
+static double benchIndexAllEdges(const BenchGraph* g, int reps, uint64_t seed) {
+    (void)seed;
+    CSRGraph* graph = buildCSRGraph(g->V, g->edges, g->E);
+    EdgeQuery* queries = (EdgeQuery*)calloc(g->E > 0 ? g->E : 1, sizeof(EdgeQuery));
+    EdgeMembership* answers = (EdgeMembership*)malloc((g->E > 0 ? g->E : 1) * sizeof(EdgeMembership));
+    for (int i = 0; i < g->E; i++) {
+        queries[i].u = g->edges[i].src;
+        queries[i].v = g->edges[i].dest;
+        queries[i].weight = g->edges[i].weight;
+    }
+    double total = 0;
+    for (int r = 0; r < reps; r++) {
+        double start = benchNow();
+        MSTIndex* index = buildMSTIndex(graph);
+        queryEdgesInMST(index, queries, g->E, answers);
+        total += benchNow() - start;
+        freeMSTIndex(index);
+    }
+    free(queries);
+    free(answers);
+    freeCSRGraph(graph);
+    return total;
+}
+
+int main(int argc, char** argv) {
+    BenchOptions opts;
+    if (!benchParseArgs(argc, argv, &opts))
+        return 2;
+    const BenchMethod methods[] = {
+        {"isEdgeInMST_Kruskal", benchKruskalQuery},
+        {"isEdgeInMST_CycleProperty", benchCycleQuery},
+        {"isEdgeInMST_Prim", benchPrimQuery},
+        {"queryEdgesInMST", benchIndexAllEdges},
+    };
+    return benchRunAll("problem3", methods, sizeof(methods) / sizeof(methods[0]), &opts);
+}
@@ -0,0 +1,50 @@
+#define MST_LIBRARY_ONLY
+#include "../problem4_aug_data_struct/main.c"
+#include "bench.h"
+
+static double benchAlmostTree(const BenchGraph* g, int reps, uint64_t seed) {
+    (void)seed;
+    int *tree = (int *)malloc((g->V > 0 ? g->V : 1) * sizeof(int));
+    double total = 0;
+    for (int r = 0; r < reps; r++) {
+        double start = benchNow();
+        int size = almostTreeMST(g->V, g->edges, g->E, tree);
+        total += benchNow() - start;
+        printf("%d\n", size);
+    }
+    free(tree);
+    return total;
+}
+
+// Reference point: a full radix sort followed by a union-find pass, on a
+// copy made outside the timed region
+static double benchSortKruskal(const BenchGraph* g, int reps, uint64_t seed) {
+    (void)seed;
+    GraphEdge *copy = (GraphEdge *)malloc((g->E > 0 ? g->E : 1) * sizeof(GraphEdge));
+    double total = 0;
+    for (int r = 0; r < reps; r++) {
+        memcpy(copy, g->edges, (size_t)g->E * sizeof(GraphEdge));
+        double start = benchNow();
+        sortGraphEdgesByWeight(copy, g->E);
+        DSU *sets = createDSU(g->V);
+        int size = 0;
+        for (int i = 0; i < g->E && size < g->V - 1; i++)
+            size += dsuUnion(sets, copy[i].src, copy[i].dest);
+        freeDSU(sets);
+        total += benchNow() - start;
+        printf("%d\n", size);
+    }
+    free(copy);
+    return total;
+}
+
+int main(int argc, char **argv) {
+    BenchOptions opts;
+    if (!benchParseArgs(argc, argv, &opts))
+        return 2;
+    const BenchMethod methods[] = {
+        {"almostTreeMST", benchAlmostTree},
+        {"sortKruskal", benchSortKruskal},
+    };
+    return benchRunAll("problem4", methods, sizeof(methods) / sizeof(methods[0]), &opts);
+}
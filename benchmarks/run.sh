@@ -0,0 +1,26 @@
+#!/bin/sh
+# Build every benchmark driver and collect their rows into one CSV.
+#
+#     benchmarks/run.sh [output.csv] [--min-edges n] [--max-edges n] [--reps n] [--seed n]
+#
+# The default sweep goes from 10^3 to 10^7 edges; pass --max-edges to cut
+# it short. CC and CFLAGS override the compiler and its flags.
+set -e
+
+dir=$(cd "$(dirname "$0")" && pwd)
+out=${1:-benchmarks.csv}
+[ $# -gt 0 ] && shift
+
+CC=${CC:-gcc}
+CFLAGS=${CFLAGS:-"-O2 -march=native"}
+build=$(mktemp -d)
+trap 'rm -rf "$build"' EXIT
+
+header=""
+: > "$out"
+for problem in 1 2 3 4 5; do
+    $CC $CFLAGS -pthread -o "$build/bench_problem$problem" "$dir/bench_problem$problem.c" -lm
+    "$build/bench_problem$problem" $header "$@" >> "$out"
+    header="--no-header"
+done
+echo "Wrote $out"
@@ -0,0 +1,96 @@
+#ifndef CSR_GRAPH_H
+#define CSR_GRAPH_H
+
+#include <stdlib.h>
+#include <string.h>
+
+// Undirected weighted edge, the input format shared by every program
+typedef struct GraphEdge {
+    int src;
+    int dest;
+    int weight;
+} GraphEdge;
+
+// Compressed-sparse-row graph: the arcs leaving vertex u are stored
+// contiguously in target/weight/edgeId[offset[u] .. offset[u+1])
+typedef struct CSRGraph {
+    int V;          // Number of vertices
+    int E;          // Number of undirected edges (each one appears as two arcs)
+    int* offset;    // V + 1 row offsets into the arc arrays
+    int* target;    // Head vertex of each arc
+    int* weight;    // Weight of each arc
+    int* edgeId;    // Index of the arc's edge in the builder's input list
+} CSRGraph;
+
+// Build an undirected CSR graph from an edge list with a counting pass
+// followed by a fill pass; arcs keep the input order within each row
+static inline CSRGraph* buildCSRGraph(int V, const GraphEdge* edges, int E) {
+    CSRGraph* graph = (CSRGraph*)malloc(sizeof(CSRGraph));
+    graph->V = V;
+    graph->E = E;
+    graph->offset = (int*)calloc(V + 1, sizeof(int));
+    graph->target = (int*)malloc(2 * (size_t)E * sizeof(int));
+    graph->weight = (int*)malloc(2 * (size_t)E * sizeof(int));
+    graph->edgeId = (int*)malloc(2 * (size_t)E * sizeof(int));
+
+    // Count the degree of every vertex, shifted by one for the prefix sum
+    for (int i = 0; i < E; i++) {
+        graph->offset[edges[i].src + 1]++;
+        graph->offset[edges[i].dest + 1]++;
+    }
+    for (int v = 0; v < V; v++)
+        graph->offset[v + 1] += graph->offset[v];
+
+    // Scatter both directions of every edge into its row
+    int* cursor = (int*)malloc((V > 0 ? V : 1) * sizeof(int));
+    memcpy(cursor, graph->offset, V * sizeof(int));
+    for (int i = 0; i < E; i++) {
+        int a = cursor[edges[i].src]++;
+        graph->target[a] = edges[i].dest;
+        graph->weight[a] = edges[i].weight;
+        graph->edgeId[a] = i;
+
+        a = cursor[edges[i].dest]++;
+        graph->target[a] = edges[i].src;
+        graph->weight[a] = edges[i].weight;
+        graph->edgeId[a] = i;
+    }
+    free(cursor);
+
+    return graph;
+}
+
+// Release a graph built by buildCSRGraph
+static inline void freeCSRGraph(CSRGraph* graph) {
+    if (!graph) return;
+    free(graph->offset);
+    free(graph->target);
+    free(graph->weight);
+    free(graph->edgeId);
+    free(graph);
+}
+
+// Iteration helpers over the arcs of vertex u
+static inline int csrBegin(const CSRGraph* graph, int u) {
+    return graph->offset[u];
+}
+
+static inline int csrEnd(const CSRGraph* graph, int u) {
+    return graph->offset[u + 1];
+}
+
+static inline int csrDegree(const CSRGraph* graph, int u) {
+    return graph->offset[u + 1] - graph->offset[u];
+}
+
+// True when at least half of all vertex pairs are adjacent, the point where
+// an O(V^2) array scan beats a heap
+static inline int csrIsDense(const CSRGraph* graph) {
+    return 4 * (long long)graph->E >= (long long)graph->V * (graph->V - 1);
+}
+
+// Loop over every arc index a leaving vertex u
+#define CSR_FOR_EACH_ARC(graph, u, a) \
+    for (int a = csrBegin((graph), (u)), a##_end = csrEnd((graph), (u)); a < a##_end; a++)
+
+#endif // CSR_GRAPH_H
@@ -0,0 +1,149 @@
+#ifndef DSU_H
+#define DSU_H
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "mst_stats.h"
+
+// Disjoint-set union over the elements 0 .. n-1, shared by every
+// Kruskal-style loop. Finds are iterative with path halving, so long
+// chains cannot overflow the stack, and unions link the smaller set under
+// the larger one. Storage is one int per element: the parent index, or
+// minus the set size for a root.
+//
+// Checkpoints make a sequence of unions undoable. While a checkpoint is
+// active every union is logged and path halving is switched off, so a
+// rollback only has to restore the two slots each union wrote. Without
+// compression, union by size still bounds every find by O(log n).
+typedef struct DSU {
+    int n;              // Number of elements in use
+    int capacity;       // Allocated length of link
+    int sets;           // Number of disjoint sets
+    int* link;          // Parent, or -(set size) for a root
+    int* log;           // (hung root, its old link) pairs of logged unions
+    int logSize;
+    int logCapacity;
+    int* marks;         // Log position of every active checkpoint
+    int markCount;
+    int markCapacity;
+} DSU;
+
+// Put the first n elements back into singleton sets; n must not exceed
+// the capacity the DSU was created with. Drops every checkpoint.
+static inline void dsuReset(DSU* d, int n) {
+    d->n = n;
+    d->sets = n;
+    for (int i = 0; i < n; i++)
+        d->link[i] = -1;
+    d->logSize = 0;
+    d->markCount = 0;
+}
+
+// Create n singleton sets
+static inline DSU* createDSU(int n) {
+    DSU* d = (DSU*)calloc(1, sizeof(DSU));
+    d->capacity = n;
+    d->link = (int*)malloc((n > 0 ? n : 1) * sizeof(int));
+    STAT_ADD(bytesAllocated, sizeof(DSU) + n * sizeof(int));
+    dsuReset(d, n);
+    return d;
+}
+
+static inline void freeDSU(DSU* d) {
+    if (!d) return;
+    free(d->link);
+    free(d->log);
+    free(d->marks);
+    free(d);
+}
+
+// Root of the set containing x
+static inline int dsuFind(DSU* d, int x) {
+    STAT_INC(findCalls);
+    if (d->markCount > 0) {
+        while (d->link[x] >= 0) {
+            STAT_INC(findHops);
+            x = d->link[x];
+        }
+        return x;
+    }
+    while (d->link[x] >= 0) {
+        int parent = d->link[x];
+        if (d->link[parent] >= 0) {
+            // Path halving: point x at its grandparent and jump there
+            d->link[x] = d->link[parent];
+            parent = d->link[x];
+        }
+        STAT_INC(findHops);
+        x = parent;
+    }
+    return x;
+}
+
+static inline bool dsuSame(DSU* d, int x, int y) {
+    return dsuFind(d, x) == dsuFind(d, y);
+}
+
+// Number of elements in the set containing x
+static inline int dsuSetSize(DSU* d, int x) {
+    return -d->link[dsuFind(d, x)];
+}
+
+// Merge the sets containing x and y. Returns false if they were already
+// the same set.
+static inline bool dsuUnion(DSU* d, int x, int y) {
+    x = dsuFind(d, x);
+    y = dsuFind(d, y);
+    if (x == y) return false;
+    STAT_INC(unions);
+
+    // Hang the smaller set (x) under the larger one (y)
+    if (d->link[x] < d->link[y]) {
+        int t = x; x = y; y = t;
+    }
+    if (d->markCount > 0) {
+        if (d->logSize + 2 > d->logCapacity) {
+            d->logCapacity = d->logCapacity > 0 ? 2 * d->logCapacity : 64;
+            d->log = (int*)realloc(d->log, d->logCapacity * sizeof(int));
+        }
+        d->log[d->logSize++] = x;
+        d->log[d->logSize++] = d->link[x];
+    }
+    d->link[y] += d->link[x];
+    d->link[x] = y;
+    d->sets--;
+    return true;
+}
+
+// Start logging unions so they can be undone by dsuRollback
+static inline void dsuCheckpoint(DSU* d) {
+    if (d->markCount == d->markCapacity) {
+        d->markCapacity = d->markCapacity > 0 ? 2 * d->markCapacity : 8;
+        d->marks = (int*)realloc(d->marks, d->markCapacity * sizeof(int));
+    }
+    d->marks[d->markCount++] = d->logSize;
+}
+
+// Undo every union since the latest checkpoint and drop that checkpoint
+static inline void dsuRollback(DSU* d) {
+    int mark = d->marks[--d->markCount];
+    while (d->logSize > mark) {
+        int oldLink = d->log[--d->logSize];
+        int x = d->log[--d->logSize];
+        // x was a root of size -oldLink hung directly under its new root
+        d->link[d->link[x]] -= oldLink;
+        d->link[x] = oldLink;
+        d->sets++;
+    }
+}
+
+// Keep every union since the latest checkpoint and drop that checkpoint.
+// Once no checkpoint is left the log is cleared and compression resumes.
+static inline void dsuCommit(DSU* d) {
+    d->markCount--;
+    if (d->markCount == 0)
+        d->logSize = 0;
+}
+
+#endif // DSU_H
@@ -0,0 +1,148 @@
+#ifndef EDGE_LIST_TEXT_H
+#define EDGE_LIST_TEXT_H
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "csr_graph.h"
+
+// Reader for the plain-text edge list format:
+//
+//     V E
+//     u v w      (E lines)
+//
+// Regular files are memory-mapped and decoded in place; pipes are read into
+// a buffer first. Integers are decoded by hand, with no locale or format
+// parsing.
+
+// Position inside a text buffer
+typedef struct TextCursor {
+    const char* p;
+    const char* end;
+} TextCursor;
+
+// Fold one more decimal digit into the magnitude of an int with the given
+// sign. Returns false once the value no longer fits in an int.
+static inline bool appendDecimalDigit(long long* magnitude, int digit, bool negative) {
+    long long limit = negative ? -(long long)INT_MIN : INT_MAX;
+    *magnitude = *magnitude * 10 + digit;
+    return *magnitude <= limit;
+}
+
+// Decode the next decimal integer, skipping leading whitespace.
+// Returns false at end of input, on a malformed token, or when the value
+// is outside the range of int.
+static inline bool nextInt(TextCursor* c, int* out) {
+    const char* p = c->p;
+    const char* end = c->end;
+    while (p < end && (*p == ' ' || *p == '\n' || *p == '\t' || *p == '\r'))
+        p++;
+    if (p == end)
+        return false;
+
+    bool negative = false;
+    if (*p == '-' || *p == '+') {
+        negative = *p == '-';
+        p++;
+    }
+    if (p == end || (unsigned)(*p - '0') > 9)
+        return false;
+
+    long long value = 0;
+    while (p < end && (unsigned)(*p - '0') <= 9) {
+        if (!appendDecimalDigit(&value, *p - '0', negative))
+            return false;
+        p++;
+    }
+    c->p = p;
+    *out = (int)(negative ? -value : value);
+    return true;
+}
+
+// Parse a whole edge list held in memory. On success *edges is a malloc'd
+// array of *E edges over *V vertices.
+static inline bool parseEdgeListText(const char* buf, size_t len, int* V, int* E, GraphEdge** edges) {
+    TextCursor c = {buf, buf + len};
+    if (!nextInt(&c, V) || !nextInt(&c, E) || *V < 0 || *E < 0)
+        return false;
+
+    // "0 0 0" plus a separator is the shortest edge line, so a header that
+    // claims more edges than the rest of the buffer can hold is malformed
+    if ((size_t)*E > ((size_t)(c.end - c.p) + 1) / 6)
+        return false;
+    GraphEdge* list = (GraphEdge*)malloc((*E > 0 ? *E : 1) * sizeof(GraphEdge));
+    if (!list)
+        return false;
+    for (int i = 0; i < *E; i++) {
+        if (!nextInt(&c, &list[i].src) || !nextInt(&c, &list[i].dest) || !nextInt(&c, &list[i].weight) ||
+            list[i].src < 0 || list[i].src >= *V || list[i].dest < 0 || list[i].dest >= *V) {
+            free(list);
+            return false;
+        }
+    }
+    *edges = list;
+    return true;
+}
+
+// Map a regular file read-only, or return NULL if it cannot be mapped
+static inline const char* mapTextFile(int fd, size_t* len) {
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0)
+        return NULL;
+    void* map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED)
+        return NULL;
+    madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+    *len = (size_t)st.st_size;
+    return (const char*)map;
+}
+
+// Read everything left on fd into a malloc'd buffer
+static inline char* readAllText(int fd, size_t* len) {
+    size_t capacity = 1 << 16, size = 0;
+    char* buf = (char*)malloc(capacity);
+    for (;;) {
+        if (size == capacity) {
+            capacity *= 2;
+            buf = (char*)realloc(buf, capacity);
+        }
+        ssize_t got = read(fd, buf + size, capacity - size);
+        if (got <= 0) break;
+        size += (size_t)got;
+    }
+    *len = size;
+    return buf;
+}
+
+// Load an edge list from an open descriptor, mapping it when possible
+static inline bool loadEdgeListFd(int fd, int* V, int* E, GraphEdge** edges) {
+    size_t len;
+    const char* map = mapTextFile(fd, &len);
+    if (map) {
+        bool ok = parseEdgeListText(map, len, V, E, edges);
+        munmap((void*)map, len);
+        return ok;
+    }
+    char* buf = readAllText(fd, &len);
+    bool ok = parseEdgeListText(buf, len, V, E, edges);
+    free(buf);
+    return ok;
+}
+
+// Load an edge list from a file path
+static inline bool loadEdgeListFile(const char* path, int* V, int* E, GraphEdge** edges) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return false;
+    bool ok = loadEdgeListFd(fd, V, E, edges);
+    close(fd);
+    return ok;
+}
+
+#endif // EDGE_LIST_TEXT_H
@@ -0,0 +1,521 @@
+#ifndef EXTERNAL_SORT_H
+#define EXTERNAL_SORT_H
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "csr_graph.h"
+#include "radix_sort.h"
+#include "graph_file.h"
+
+// External-memory edge sort for graphs that do not fit in RAM. The edge
+// list is streamed from a graph file (binary or text) in pieces that fit
+// the memory budget; each piece is sorted with sortGraphEdgesByWeight and
+// written to an unlinked temporary file as a run. The runs are then merged
+// with a heap keyed on (weight, run), so consumers read the edges in
+// weight order one at a time. Runs hold consecutive pieces of the input
+// and ties go to the earlier run, which makes the merged order exactly the
+// stable in-memory order: Kruskal-style consumers pick the same edges as
+// the in-memory engines.
+//
+//     ExternalEdgeSort sorted;
+//     if (externalSortOpen(path, &opts, &sorted))
+//         while (externalSortNext(&sorted, &e)) ...
+//     externalSortClose(&sorted);
+//
+// With rowOrder set, edges come out as an edge list extracted row by row
+// from a CSR graph and then sorted would: stored as (lower, higher)
+// endpoint, self-loops dropped, and equal weights ordered by lower
+// endpoint before input position.
+//
+// A graph that fits in one run never touches the disk. When there are
+// more runs than read buffers fit in the budget, groups of runs are first
+// merged into longer runs.
+
+#define EXTERNAL_DEFAULT_MEMORY_MB 256
+
+// Bytes per edge while a run is sorted: the edge itself plus the 64-bit
+// keys, permutation, copy and radix scratch of the run sort
+#define EXTERNAL_SORT_BYTES_PER_EDGE 56
+
+// Smallest read buffer given to one run during a merge
+#define EXTERNAL_MIN_RUN_BUFFER ((size_t)64 << 10)
+
+typedef struct ExternalOptions {
+    size_t memoryBudget;    // Bytes for run and merge buffers
+    const char* tempDir;    // Directory for runs; NULL uses $TMPDIR or /tmp
+    bool rowOrder;          // Break ties like an edge list read from a CSR graph
+    bool invalid;           // --memory-mb was missing or not a positive size
+} ExternalOptions;
+
+typedef struct ExternalIOStats {
+    uint64_t bytesRead;     // Graph input plus run reads
+    uint64_t bytesWritten;  // Run writes
+    int runs;               // Sorted runs cut from the input
+    int mergePasses;        // Extra passes forced by the merge fan-in
+} ExternalIOStats;
+
+// Sequential reader over a graph file's edges
+typedef struct EdgeStream {
+    FILE* file;
+    bool binary;
+    int V;
+    int E;
+    int left;               // Edges not read yet
+    bool truncated;         // The input ended before E edges
+    bool invalid;           // An edge named a vertex outside [0, V)
+} EdgeStream;
+
+// One sorted run: a file read through a buffer, or a buffer that never
+// left memory
+typedef struct ExternalRun {
+    FILE* file;
+    GraphEdge* buffer;
+    size_t capacity;
+    size_t length;          // Edges in the buffer
+    size_t position;        // Next edge in the buffer
+    uint64_t left;          // Edges still in the file
+} ExternalRun;
+
+// k-way merge over consecutive runs
+typedef struct ExternalMerge {
+    ExternalRun* runs;
+    int count;
+    int* heap;              // Run indices with edges left, least head first
+    int heapSize;
+    ExternalIOStats* stats;
+    bool rowOrder;
+    bool failed;
+} ExternalMerge;
+
+typedef struct ExternalEdgeSort {
+    int V;
+    int E;
+    ExternalRun* runs;
+    int runCount;
+    ExternalMerge merge;
+    ExternalIOStats stats;
+} ExternalEdgeSort;
+
+static inline void externalDefaultOptions(ExternalOptions* opts) {
+    opts->memoryBudget = (size_t)EXTERNAL_DEFAULT_MEMORY_MB << 20;
+    opts->tempDir = NULL;
+    opts->rowOrder = false;
+    opts->invalid = false;
+}
+
+// Parse a --memory-mb value: a positive whole number of megabytes whose
+// byte count fits in size_t
+static inline bool externalParseMemoryMB(const char* text, size_t* bytes) {
+    char* end;
+    errno = 0;
+    long mb = strtol(text, &end, 10);
+    if (errno != 0 || end == text || *end != '\0' || mb <= 0 || (unsigned long)mb >= (SIZE_MAX >> 20))
+        return false;
+    *bytes = (size_t)mb << 20;
+    return true;
+}
+
+// Remove --external, --memory-mb <n> and --temp-dir <dir> from argv,
+// filling opts, and report whether --external was present. A bad or
+// missing --memory-mb value sets opts->invalid.
+static inline bool externalTakeOptions(int* argc, char** argv, ExternalOptions* opts) {
+    bool found = false;
+    int kept = 1;
+    externalDefaultOptions(opts);
+    for (int i = 1; i < *argc; i++) {
+        if (strcmp(argv[i], "--external") == 0)
+            found = true;
+        else if (strcmp(argv[i], "--memory-mb") == 0) {
+            if (i + 1 == *argc || !externalParseMemoryMB(argv[++i], &opts->memoryBudget))
+                opts->invalid = true;
+        } else if (strcmp(argv[i], "--temp-dir") == 0 && i + 1 < *argc)
+            opts->tempDir = argv[++i];
+        else
+            argv[kept++] = argv[i];
+    }
+    *argc = kept;
+    argv[kept] = NULL;
+    return found;
+}
+
+static inline void externalPrintIOStats(FILE* out, const ExternalIOStats* stats) {
+    fprintf(out, "External sort: %d runs, %d extra merge passes, %.1f MB read, %.1f MB written\n",
+            stats->runs, stats->mergePasses, stats->bytesRead / 1048576.0, stats->bytesWritten / 1048576.0);
+}
+
+// Decode the next decimal integer from a text stream. Digits go through
+// the same appendDecimalDigit as nextInt, so both readers accept exactly
+// the same values.
+static inline bool streamInt(FILE* f, int* out) {
+    int c = getc_unlocked(f);
+    while (c == ' ' || c == '\n' || c == '\t' || c == '\r')
+        c = getc_unlocked(f);
+    bool negative = false;
+    if (c == '-' || c == '+') {
+        negative = c == '-';
+        c = getc_unlocked(f);
+    }
+    if ((unsigned)(c - '0') > 9)
+        return false;
+    long long value = 0;
+    while ((unsigned)(c - '0') <= 9) {
+        if (!appendDecimalDigit(&value, c - '0', negative))
+            return false;
+        c = getc_unlocked(f);
+    }
+    *out = (int)(negative ? -value : value);
+    return true;
+}
+
+// Open a graph file for streaming; "-" reads a text edge list from stdin
+static inline bool openEdgeStream(const char* path, EdgeStream* s) {
+    memset(s, 0, sizeof(*s));
+    if (strcmp(path, "-") == 0) {
+        s->file = stdin;
+    } else {
+        s->binary = isGraphFile(path);
+        s->file = fopen(path, s->binary ? "rb" : "r");
+        if (!s->file)
+            return false;
+    }
+    if (s->binary) {
+        GraphFileHeader header;
+        struct stat st;
+        if (fread(&header, sizeof(header), 1, s->file) != 1 || fstat(fileno(s->file), &st) != 0 ||
+            !graphFileHeaderValid(&header, (uint64_t)st.st_size) ||
+            fseeko(s->file, (off_t)header.edgeOffset, SEEK_SET) != 0) {
+            fclose(s->file);
+            return false;
+        }
+        s->V = header.V;
+        s->E = header.E;
+    } else if (!streamInt(s->file, &s->V) || !streamInt(s->file, &s->E) || s->V < 0 || s->E < 0) {
+        if (s->file != stdin)
+            fclose(s->file);
+        return false;
+    }
+    s->left = s->E;
+    return true;
+}
+
+// Read up to max edges; returns how many were read. Stops at the first
+// edge with an endpoint outside [0, V) and marks the stream invalid.
+static inline size_t readEdgeStream(EdgeStream* s, GraphEdge* out, size_t max) {
+    size_t n = max < (size_t)s->left ? max : (size_t)s->left;
+    if (s->binary) {
+        n = fread(out, sizeof(GraphEdge), n, s->file);
+    } else {
+        for (size_t i = 0; i < n; i++) {
+            if (!streamInt(s->file, &out[i].src) || !streamInt(s->file, &out[i].dest) ||
+                !streamInt(s->file, &out[i].weight)) {
+                n = i;
+                break;
+            }
+        }
+    }
+    for (size_t i = 0; i < n; i++) {
+        if ((unsigned)out[i].src >= (unsigned)s->V || (unsigned)out[i].dest >= (unsigned)s->V) {
+            s->invalid = true;
+            s->left = 0;
+            return i;
+        }
+    }
+    s->left -= (int)n;
+    if (n < max && s->left > 0) {
+        s->truncated = true;
+        s->left = 0;
+    }
+    return n;
+}
+
+// Bytes consumed so far, then close
+static inline uint64_t closeEdgeStream(EdgeStream* s) {
+    off_t pos = ftello(s->file);
+    if (s->file != stdin)
+        fclose(s->file);
+    s->file = NULL;
+    return pos > 0 ? (uint64_t)pos : 0;
+}
+
+// Anonymous temporary file: unlinked as soon as it is created, so it
+// disappears when closed or when the process dies
+static inline FILE* externalTempFile(const char* dir) {
+    if (!dir) dir = getenv("TMPDIR");
+    if (!dir || !*dir) dir = "/tmp";
+    size_t len = strlen(dir) + sizeof("/mst-run-XXXXXX");
+    char* name = (char*)malloc(len);
+    snprintf(name, len, "%s/mst-run-XXXXXX", dir);
+    int fd = mkstemp(name);
+    if (fd >= 0)
+        unlink(name);
+    free(name);
+    if (fd < 0)
+        return NULL;
+    FILE* f = fdopen(fd, "w+b");
+    if (!f)
+        close(fd);
+    return f;
+}
+
+// Make the run's next edge available; false once the run is exhausted
+static inline bool externalRunFill(ExternalRun* run, ExternalMerge* m) {
+    if (run->position < run->length)
+        return true;
+    if (!run->file || run->left == 0)
+        return false;
+    size_t want = run->left < run->capacity ? (size_t)run->left : run->capacity;
+    size_t got = fread(run->buffer, sizeof(GraphEdge), want, run->file);
+    m->stats->bytesRead += got * sizeof(GraphEdge);
+    if (got < want) {
+        m->failed = true;
+        run->left = 0;
+    } else {
+        run->left -= got;
+    }
+    run->length = got;
+    run->position = 0;
+    return got > 0;
+}
+
+// Heap order: lighter head first (then lower endpoint in row order),
+// then the earlier run
+static inline bool externalBefore(const ExternalMerge* m, int a, int b) {
+    const GraphEdge* x = &m->runs[a].buffer[m->runs[a].position];
+    const GraphEdge* y = &m->runs[b].buffer[m->runs[b].position];
+    if (x->weight != y->weight)
+        return x->weight < y->weight;
+    if (m->rowOrder && x->src != y->src)
+        return x->src < y->src;
+    return a < b;
+}
+
+static inline void externalSiftDown(ExternalMerge* m, int i) {
+    for (;;) {
+        int least = i, l = 2 * i + 1, r = l + 1;
+        if (l < m->heapSize && externalBefore(m, m->heap[l], m->heap[least])) least = l;
+        if (r < m->heapSize && externalBefore(m, m->heap[r], m->heap[least])) least = r;
+        if (least == i)
+            return;
+        int t = m->heap[i]; m->heap[i] = m->heap[least]; m->heap[least] = t;
+        i = least;
+    }
+}
+
+static inline void externalMergeStart(ExternalMerge* m, ExternalRun* runs, int count, ExternalIOStats* stats,
+                                      bool rowOrder) {
+    m->runs = runs;
+    m->rowOrder = rowOrder;
+    m->count = count;
+    m->heap = (int*)malloc((count > 0 ? count : 1) * sizeof(int));
+    m->heapSize = 0;
+    m->stats = stats;
+    m->failed = false;
+    for (int r = 0; r < count; r++)
+        if (externalRunFill(&runs[r], m))
+            m->heap[m->heapSize++] = r;
+    for (int i = m->heapSize / 2 - 1; i >= 0; i--)
+        externalSiftDown(m, i);
+}
+
+static inline bool externalMergeNext(ExternalMerge* m, GraphEdge* e) {
+    if (m->heapSize == 0)
+        return false;
+    ExternalRun* run = &m->runs[m->heap[0]];
+    *e = run->buffer[run->position++];
+    if (!externalRunFill(run, m))
+        m->heap[0] = m->heap[--m->heapSize];
+    externalSiftDown(m, 0);
+    return true;
+}
+
+static inline void externalFreeRun(ExternalRun* run) {
+    if (run->file)
+        fclose(run->file);
+    free(run->buffer);
+    memset(run, 0, sizeof(*run));
+}
+
+// Give each of count runs a read buffer of bufferBytes and rewind it.
+// Returns false if a buffer could not be allocated.
+static inline bool externalPrepareRuns(ExternalRun* runs, int count, size_t bufferBytes) {
+    for (int r = 0; r < count; r++) {
+        if (!runs[r].file) continue;
+        runs[r].capacity = bufferBytes / sizeof(GraphEdge);
+        runs[r].buffer = (GraphEdge*)malloc(runs[r].capacity * sizeof(GraphEdge));
+        if (!runs[r].buffer)
+            return false;
+        runs[r].length = runs[r].position = 0;
+        rewind(runs[r].file);
+    }
+    return true;
+}
+
+// Sort one piece of the input in place; returns its new length, which is
+// shorter in row order once self-loops are dropped
+static inline size_t externalSortPiece(GraphEdge* piece, size_t n, bool rowOrder) {
+    if (!rowOrder) {
+        sortGraphEdgesByWeight(piece, n);
+        return n;
+    }
+    size_t kept = 0;
+    for (size_t i = 0; i < n; i++) {
+        GraphEdge e = piece[i];
+        if (e.src == e.dest) continue;
+        if (e.src > e.dest) {
+            int t = e.src; e.src = e.dest; e.dest = t;
+        }
+        piece[kept++] = e;
+    }
+    if (kept < 2)
+        return kept;
+    int64_t* keys = (int64_t*)malloc(kept * sizeof(int64_t));
+    int* order = (int*)malloc(kept * sizeof(int));
+    GraphEdge* sorted = (GraphEdge*)malloc(kept * sizeof(GraphEdge));
+    for (size_t i = 0; i < kept; i++)
+        keys[i] = (int64_t)piece[i].weight * ((int64_t)1 << 32) + piece[i].src;
+    radixSortOrder64(keys, kept, order);
+    for (size_t i = 0; i < kept; i++)
+        sorted[i] = piece[order[i]];
+    memcpy(piece, sorted, kept * sizeof(GraphEdge));
+    free(keys);
+    free(order);
+    free(sorted);
+    return kept;
+}
+
+// Sort the edges of the graph file at path and position s at the lightest
+static inline bool externalSortOpen(const char* path, const ExternalOptions* opts, ExternalEdgeSort* s) {
+    memset(s, 0, sizeof(*s));
+    EdgeStream in;
+    if (!openEdgeStream(path, &in))
+        return false;
+    s->V = in.V;
+    s->E = in.E;
+    size_t budget = opts->memoryBudget > 2 * EXTERNAL_MIN_RUN_BUFFER ? opts->memoryBudget : 2 * EXTERNAL_MIN_RUN_BUFFER;
+    bool ok = true;
+
+    // Cut the input into sorted runs, no longer than the whole input
+    size_t runEdges = budget / EXTERNAL_SORT_BYTES_PER_EDGE;
+    if (runEdges > (size_t)in.E)
+        runEdges = in.E > 0 ? (size_t)in.E : 1;
+    GraphEdge* piece = (GraphEdge*)malloc(runEdges * sizeof(GraphEdge));
+    int runCapacity = 8;
+    s->runs = (ExternalRun*)calloc(runCapacity, sizeof(ExternalRun));
+    ok = piece != NULL && s->runs != NULL;
+    while (ok) {
+        size_t n = readEdgeStream(&in, piece, runEdges);
+        if (n == 0 && s->runCount > 0)
+            break;
+        n = externalSortPiece(piece, n, opts->rowOrder);
+        if (s->runCount == runCapacity) {
+            runCapacity *= 2;
+            s->runs = (ExternalRun*)realloc(s->runs, runCapacity * sizeof(ExternalRun));
+        }
+        ExternalRun* run = &s->runs[s->runCount++];
+        memset(run, 0, sizeof(*run));
+        if (s->runCount == 1 && in.left == 0) {
+            // Everything fit in one piece: keep it in memory
+            run->buffer = piece;
+            run->capacity = runEdges;
+            run->length = n;
+            piece = NULL;
+            break;
+        }
+        run->file = externalTempFile(opts->tempDir);
+        if (!run->file || fwrite(piece, sizeof(GraphEdge), n, run->file) != n) {
+            ok = false;
+            break;
+        }
+        run->left = n;
+        s->stats.bytesWritten += n * sizeof(GraphEdge);
+        if (in.left == 0)
+            break;
+    }
+    free(piece);
+    ok = ok && !in.truncated && !in.invalid;
+    s->stats.runs = s->runCount;
+    s->stats.bytesRead += closeEdgeStream(&in);
+
+    // Merge groups of runs until every remaining run gets a read buffer
+    int fanIn = (int)(budget / EXTERNAL_MIN_RUN_BUFFER) - 1;
+    if (fanIn < 2) fanIn = 2;
+    while (ok && s->runCount > fanIn) {
+        int merged = 0;
+        for (int lo = 0; lo < s->runCount && ok; lo += fanIn) {
+            int count = s->runCount - lo < fanIn ? s->runCount - lo : fanIn;
+            size_t share = budget / (count + 1);
+            ok = externalPrepareRuns(&s->runs[lo], count, share);
+            ExternalRun out;
+            memset(&out, 0, sizeof(out));
+            out.file = externalTempFile(opts->tempDir);
+            out.capacity = share / sizeof(GraphEdge);
+            out.buffer = (GraphEdge*)malloc(out.capacity * sizeof(GraphEdge));
+            ok = ok && out.file != NULL && out.buffer != NULL;
+
+            ExternalMerge m;
+            externalMergeStart(&m, &s->runs[lo], count, &s->stats, opts->rowOrder);
+            GraphEdge e;
+            while (ok && externalMergeNext(&m, &e)) {
+                out.buffer[out.length++] = e;
+                if (out.length == out.capacity) {
+                    ok = fwrite(out.buffer, sizeof(GraphEdge), out.length, out.file) == out.length;
+                    s->stats.bytesWritten += out.length * sizeof(GraphEdge);
+                    out.left += out.length;
+                    out.length = 0;
+                }
+            }
+            if (ok && out.length > 0) {
+                ok = fwrite(out.buffer, sizeof(GraphEdge), out.length, out.file) == out.length;
+                s->stats.bytesWritten += out.length * sizeof(GraphEdge);
+                out.left += out.length;
+            }
+            ok = ok && !m.failed;
+            free(m.heap);
+            for (int r = lo; r < lo + count; r++)
+                externalFreeRun(&s->runs[r]);
+            free(out.buffer);
+            out.buffer = NULL;
+            out.length = 0;
+            s->runs[merged++] = out;
+        }
+        // Only an aborted pass leaves runs behind the merged ones
+        for (int r = merged; r < s->runCount; r++)
+            externalFreeRun(&s->runs[r]);
+        s->runCount = merged;
+        s->stats.mergePasses++;
+    }
+
+    if (ok)
+        ok = externalPrepareRuns(s->runs, s->runCount, budget / (s->runCount > 0 ? s->runCount : 1));
+    if (ok) {
+        externalMergeStart(&s->merge, s->runs, s->runCount, &s->stats, opts->rowOrder);
+    }
+    return ok;
+}
+
+// Next edge in (weight, input position) order; false at the end
+static inline bool externalSortNext(ExternalEdgeSort* s, GraphEdge* e) {
+    return externalMergeNext(&s->merge, e);
+}
+
+// True if a run could not be read back completely
+static inline bool externalSortFailed(const ExternalEdgeSort* s) {
+    return s->merge.failed;
+}
+
+static inline void externalSortClose(ExternalEdgeSort* s) {
+    for (int r = 0; r < s->runCount; r++)
+        externalFreeRun(&s->runs[r]);
+    free(s->runs);
+    free(s->merge.heap);
+    memset(s, 0, sizeof(*s));
+}
+
+#endif // EXTERNAL_SORT_H
@@ -0,0 +1,253 @@
+#ifndef GRAPH_FILE_H
+#define GRAPH_FILE_H
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "csr_graph.h"
+#include "edge_list_text.h"
+
+// Binary graph file, designed to be mmap'd and used in place:
+//
+//     GraphFileHeader                    (48 bytes)
+//     GraphEdge edges[E]                 at edgeOffset, 3 x int32 each
+//     int32 offset[V + 1]                at csrOffset, only with GRAPH_FILE_HAS_CSR
+//     int32 target[2E], weight[2E], edgeId[2E]
+//
+// Integers are stored in the byte order of the host that wrote the file,
+// and the header records it in byteOrder. Every section starts on an 8-byte
+// boundary after the header, and the CSR section follows the edge array.
+// Readers reject files with a different magic, version or byte order, and
+// check every endpoint and CSR entry once when the file is opened, so the
+// programs can index with them exactly as they do with a parsed text file.
+
+#define GRAPH_FILE_MAGIC "MSTGRAPH"
+#define GRAPH_FILE_VERSION 2
+#define GRAPH_FILE_HAS_CSR 0x1u
+#define GRAPH_FILE_BYTE_ORDER 0x01020304u
+
+typedef struct GraphFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    int32_t V;
+    int32_t E;
+    uint64_t edgeOffset;    // Byte offset of the edge array
+    uint64_t csrOffset;     // Byte offset of the CSR section, 0 if absent
+    uint32_t byteOrder;     // GRAPH_FILE_BYTE_ORDER as the writer stored it
+    uint32_t reserved;
+} GraphFileHeader;
+
+_Static_assert(sizeof(GraphEdge) == 12, "GraphEdge must be three packed int32 fields");
+_Static_assert(sizeof(GraphFileHeader) == 48, "GraphFileHeader layout changed");
+
+// A graph opened from disk. Binary files are mapped and every array points
+// into the mapping; text files are parsed into owned arrays.
+typedef struct MappedGraph {
+    int V;
+    int E;
+    GraphEdge* edges;
+    const CSRGraph* csr;    // NULL until graphFileCSR is called, unless the file has one
+    CSRGraph mappedCSR;     // CSR view into the mapping
+    CSRGraph* ownedCSR;     // CSR built on demand
+    GraphEdge* ownedEdges;  // Edges parsed from a text file
+    void* map;
+    size_t length;
+} MappedGraph;
+
+static inline size_t graphFileAlign(size_t offset) {
+    return (offset + 7) & ~(size_t)7;
+}
+
+// True if path starts with the binary graph magic
+static inline bool isGraphFile(const char* path) {
+    char magic[8];
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return false;
+    bool match = read(fd, magic, sizeof(magic)) == (ssize_t)sizeof(magic) &&
+                 memcmp(magic, GRAPH_FILE_MAGIC, sizeof(magic)) == 0;
+    close(fd);
+    return match;
+}
+
+// Write a binary graph file, optionally with a CSR section
+static inline bool writeGraphFile(const char* path, int V, const GraphEdge* edges, int E, bool withCSR) {
+    FILE* f = fopen(path, "wb");
+    if (!f)
+        return false;
+
+    GraphFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, GRAPH_FILE_MAGIC, sizeof(header.magic));
+    header.version = GRAPH_FILE_VERSION;
+    header.byteOrder = GRAPH_FILE_BYTE_ORDER;
+    header.flags = withCSR ? GRAPH_FILE_HAS_CSR : 0;
+    header.V = V;
+    header.E = E;
+    header.edgeOffset = graphFileAlign(sizeof(header));
+    size_t edgeEnd = header.edgeOffset + (size_t)E * sizeof(GraphEdge);
+    header.csrOffset = withCSR ? graphFileAlign(edgeEnd) : 0;
+
+    static const char zeros[8] = {0};
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+    ok = ok && fwrite(zeros, 1, header.edgeOffset - sizeof(header), f) == header.edgeOffset - sizeof(header);
+    ok = ok && fwrite(edges, sizeof(GraphEdge), E, f) == (size_t)E;
+
+    if (ok && withCSR) {
+        CSRGraph* csr = buildCSRGraph(V, edges, E);
+        size_t arcs = 2 * (size_t)E;
+        ok = fwrite(zeros, 1, header.csrOffset - edgeEnd, f) == header.csrOffset - edgeEnd;
+        ok = ok && fwrite(csr->offset, sizeof(int), V + 1, f) == (size_t)V + 1;
+        ok = ok && fwrite(csr->target, sizeof(int), arcs, f) == arcs;
+        ok = ok && fwrite(csr->weight, sizeof(int), arcs, f) == arcs;
+        ok = ok && fwrite(csr->edgeId, sizeof(int), arcs, f) == arcs;
+        freeCSRGraph(csr);
+    }
+
+    return fclose(f) == 0 && ok;
+}
+
+// True if a section of size bytes at offset lies inside a file of length
+// bytes and starts on an 8-byte boundary, without overflowing
+static inline bool graphFileSectionFits(uint64_t offset, uint64_t size, uint64_t length) {
+    return offset % 8 == 0 && offset >= sizeof(GraphFileHeader) &&
+           offset <= length && size <= length - offset;
+}
+
+// Check a header against the length of its file: magic, version, byte
+// order, counts, and the placement of every section
+static inline bool graphFileHeaderValid(const GraphFileHeader* header, uint64_t length) {
+    if (memcmp(header->magic, GRAPH_FILE_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != GRAPH_FILE_VERSION || header->byteOrder != GRAPH_FILE_BYTE_ORDER ||
+        header->V < 0 || header->E < 0)
+        return false;
+    uint64_t edgeBytes = (uint64_t)header->E * sizeof(GraphEdge);
+    if (!graphFileSectionFits(header->edgeOffset, edgeBytes, length))
+        return false;
+    if (!(header->flags & GRAPH_FILE_HAS_CSR))
+        return true;
+
+    // Row offsets are ints, so the 2E arcs must be countable in one
+    uint64_t arcs = 2 * (uint64_t)header->E;
+    uint64_t csrBytes = ((uint64_t)header->V + 1 + 3 * arcs) * sizeof(int);
+    return arcs <= INT_MAX && header->csrOffset >= header->edgeOffset + edgeBytes &&
+           graphFileSectionFits(header->csrOffset, csrBytes, length);
+}
+
+// True if every edge endpoint is a vertex of the graph
+static inline bool graphEdgesValid(const GraphEdge* edges, int E, int V) {
+    for (int i = 0; i < E; i++) {
+        if ((unsigned)edges[i].src >= (unsigned)V || (unsigned)edges[i].dest >= (unsigned)V)
+            return false;
+    }
+    return true;
+}
+
+// True if the row offsets run from 0 to 2E without decreasing, and every
+// arc names a vertex and an edge of the graph
+static inline bool graphCSRValid(const CSRGraph* csr) {
+    if (csr->offset[0] != 0 || csr->offset[csr->V] != 2 * csr->E)
+        return false;
+    for (int v = 0; v < csr->V; v++) {
+        if (csr->offset[v] > csr->offset[v + 1])
+            return false;
+    }
+    for (int a = 0; a < 2 * csr->E; a++) {
+        if ((unsigned)csr->target[a] >= (unsigned)csr->V || (unsigned)csr->edgeId[a] >= (unsigned)csr->E)
+            return false;
+    }
+    return true;
+}
+
+// Map a binary graph file; nothing is copied or parsed. The mapping is
+// private and writable, so a caller that sorts the edges in place only
+// copies the pages it touches and never modifies the file.
+static inline bool mapGraphFile(const char* path, MappedGraph* g) {
+    memset(g, 0, sizeof(*g));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (uint64_t)st.st_size < sizeof(GraphFileHeader)) {
+        close(fd);
+        return false;
+    }
+    void* map = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+        return false;
+
+    const GraphFileHeader* header = (const GraphFileHeader*)map;
+    size_t length = (size_t)st.st_size;
+    size_t arcs = 2 * (size_t)header->E;
+    if (!graphFileHeaderValid(header, length)) {
+        munmap(map, length);
+        return false;
+    }
+
+    g->map = map;
+    g->length = length;
+    g->V = header->V;
+    g->E = header->E;
+    g->edges = (GraphEdge*)((char*)map + header->edgeOffset);
+    if (header->flags & GRAPH_FILE_HAS_CSR) {
+        int* base = (int*)((char*)map + header->csrOffset);
+        g->mappedCSR.V = g->V;
+        g->mappedCSR.E = g->E;
+        g->mappedCSR.offset = base;
+        g->mappedCSR.target = base + g->V + 1;
+        g->mappedCSR.weight = g->mappedCSR.target + arcs;
+        g->mappedCSR.edgeId = g->mappedCSR.weight + arcs;
+        g->csr = &g->mappedCSR;
+    }
+
+    // One pass over the arrays, so a corrupt file fails here instead of
+    // sending an index out of bounds later
+    if (!graphEdgesValid(g->edges, g->E, g->V) || (g->csr && !graphCSRValid(g->csr))) {
+        munmap(map, length);
+        memset(g, 0, sizeof(*g));
+        return false;
+    }
+    return true;
+}
+
+// Open a graph in either format: binary files are mapped, anything else is
+// parsed as a text edge list
+static inline bool openGraphFile(const char* path, MappedGraph* g) {
+    if (isGraphFile(path))
+        return mapGraphFile(path, g);
+    memset(g, 0, sizeof(*g));
+    if (!loadEdgeListFile(path, &g->V, &g->E, &g->ownedEdges))
+        return false;
+    g->edges = g->ownedEdges;
+    return true;
+}
+
+// CSR view of the graph: the mapped section if the file has one,
+// otherwise built once from the edge list
+static inline const CSRGraph* graphFileCSR(MappedGraph* g) {
+    if (!g->csr) {
+        g->ownedCSR = buildCSRGraph(g->V, g->edges, g->E);
+        g->csr = g->ownedCSR;
+    }
+    return g->csr;
+}
+
+static inline void closeGraphFile(MappedGraph* g) {
+    if (g->map)
+        munmap(g->map, g->length);
+    freeCSRGraph(g->ownedCSR);
+    free(g->ownedEdges);
+    memset(g, 0, sizeof(*g));
+}
+
+#endif // GRAPH_FILE_H
@@ -0,0 +1,123 @@
+#ifndef INDEXED_HEAP_H
+#define INDEXED_HEAP_H
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+// Number of children per heap node; override with -DINDEXED_HEAP_ARITY=n
+#ifndef INDEXED_HEAP_ARITY
+#define INDEXED_HEAP_ARITY 4
+#endif
+
+// Indexed d-ary min-heap over the items 0 .. capacity-1. Items are ordered
+// by (key, item) so ties resolve to the smaller item, exactly like a
+// linear scan for the minimum key would.
+typedef struct IndexedHeap {
+    int size;       // Number of items currently in the heap
+    int* heap;      // Heap-ordered items
+    int* pos;       // Position of each item in heap, or -1 if absent
+    int* key;       // Current key of each item
+} IndexedHeap;
+
+// Create an empty heap able to hold items 0 .. capacity-1
+static inline IndexedHeap* createIndexedHeap(int capacity) {
+    IndexedHeap* h = (IndexedHeap*)malloc(sizeof(IndexedHeap));
+    h->size = 0;
+    h->heap = (int*)malloc((capacity > 0 ? capacity : 1) * sizeof(int));
+    h->pos = (int*)malloc((capacity > 0 ? capacity : 1) * sizeof(int));
+    h->key = (int*)malloc((capacity > 0 ? capacity : 1) * sizeof(int));
+    for (int i = 0; i < capacity; i++)
+        h->pos[i] = -1;
+    return h;
+}
+
+static inline void freeIndexedHeap(IndexedHeap* h) {
+    if (!h) return;
+    free(h->heap);
+    free(h->pos);
+    free(h->key);
+    free(h);
+}
+
+static inline bool heapIsEmpty(const IndexedHeap* h) {
+    return h->size == 0;
+}
+
+static inline bool heapContains(const IndexedHeap* h, int item) {
+    return h->pos[item] != -1;
+}
+
+// True if item a must sit above item b
+static inline bool heapLess(const IndexedHeap* h, int a, int b) {
+    return h->key[a] < h->key[b] || (h->key[a] == h->key[b] && a < b);
+}
+
+// Move the item at heap position i towards the root
+static inline void heapSiftUp(IndexedHeap* h, int i) {
+    int item = h->heap[i];
+    while (i > 0) {
+        int p = (i - 1) / INDEXED_HEAP_ARITY;
+        if (!heapLess(h, item, h->heap[p])) break;
+        h->heap[i] = h->heap[p];
+        h->pos[h->heap[i]] = i;
+        i = p;
+    }
+    h->heap[i] = item;
+    h->pos[item] = i;
+}
+
+// Move the item at heap position i towards the leaves
+static inline void heapSiftDown(IndexedHeap* h, int i) {
+    int item = h->heap[i];
+    for (;;) {
+        int first = i * INDEXED_HEAP_ARITY + 1;
+        if (first >= h->size) break;
+        int last = first + INDEXED_HEAP_ARITY;
+        if (last > h->size) last = h->size;
+
+        // Pick the smallest child
+        int best = first;
+        for (int c = first + 1; c < last; c++)
+            if (heapLess(h, h->heap[c], h->heap[best]))
+                best = c;
+
+        if (!heapLess(h, h->heap[best], item)) break;
+        h->heap[i] = h->heap[best];
+        h->pos[h->heap[i]] = i;
+        i = best;
+    }
+    h->heap[i] = item;
+    h->pos[item] = i;
+}
+
+// Insert item with the given key, or lower its key if it is already queued.
+// Returns true if the heap changed.
+static inline bool heapPushOrDecrease(IndexedHeap* h, int item, int key) {
+    if (h->pos[item] == -1) {
+        h->key[item] = key;
+        h->heap[h->size] = item;
+        h->pos[item] = h->size;
+        h->size++;
+    } else if (key < h->key[item]) {
+        h->key[item] = key;
+    } else {
+        return false;
+    }
+    heapSiftUp(h, h->pos[item]);
+    return true;
+}
+
+// Remove and return the item with the smallest key
+static inline int heapPopMin(IndexedHeap* h) {
+    int top = h->heap[0];
+    h->pos[top] = -1;
+    h->size--;
+    if (h->size > 0) {
+        h->heap[0] = h->heap[h->size];
+        h->pos[h->heap[0]] = 0;
+        heapSiftDown(h, 0);
+    }
+    return top;
+}
+
+#endif // INDEXED_HEAP_H
@@ -0,0 +1,110 @@
+#ifndef MST_STATS_H
+#define MST_STATS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+// Opt-in operation counters and phase timers. Build with -DMST_STATS to
+// enable them; otherwise every STAT_* macro expands to nothing and the
+// instrumented code is unchanged. The counters live in one global per
+// program and are not thread-safe, so parallel engines are not counted.
+//
+//     STAT_INC(findCalls);                   count one event
+//     STAT_ADD(bytesAllocated, n);           count n events
+//     STAT_TIMER_START(t);                   start a monotonic timer
+//     STAT_TIMER_STOP(t, "kruskal.sort");    add the elapsed time to a phase
+
+// Maximum number of distinct phase names
+#define MST_STATS_MAX_PHASES 32
+
+typedef struct MSTStatsPhase {
+    const char* name;
+    uint64_t calls;
+    double seconds;
+} MSTStatsPhase;
+
+typedef struct MSTStats {
+    uint64_t findCalls;         // Union-find root lookups
+    uint64_t findHops;          // Parent links followed by those lookups
+    uint64_t unions;            // Unions that merged two sets
+    uint64_t edgesScanned;      // Edges or arcs examined
+    uint64_t keyUpdates;        // Prim key decreases
+    uint64_t bytesAllocated;    // Bytes requested by instrumented allocations
+    int phaseCount;
+    MSTStatsPhase phases[MST_STATS_MAX_PHASES];
+} MSTStats;
+
+static MSTStats mstStats;
+
+static inline double mstStatsNow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Add one timed run to the phase called name
+static inline void mstStatsAddPhase(const char* name, double seconds) {
+    for (int i = 0; i < mstStats.phaseCount; i++) {
+        if (strcmp(mstStats.phases[i].name, name) == 0) {
+            mstStats.phases[i].calls++;
+            mstStats.phases[i].seconds += seconds;
+            return;
+        }
+    }
+    if (mstStats.phaseCount == MST_STATS_MAX_PHASES) return;
+    MSTStatsPhase* phase = &mstStats.phases[mstStats.phaseCount++];
+    phase->name = name;
+    phase->calls = 1;
+    phase->seconds = seconds;
+}
+
+#ifdef MST_STATS
+#define STAT_INC(field) (mstStats.field++)
+#define STAT_ADD(field, n) (mstStats.field += (uint64_t)(n))
+#define STAT_TIMER_START(t) double t = mstStatsNow()
+#define STAT_TIMER_STOP(t, name) mstStatsAddPhase((name), mstStatsNow() - (t))
+#else
+#define STAT_INC(field) ((void)0)
+#define STAT_ADD(field, n) ((void)0)
+#define STAT_TIMER_START(t) ((void)0)
+#define STAT_TIMER_STOP(t, name) ((void)0)
+#endif
+
+// Remove every "--stats" from argv and report whether one was present
+static inline bool mstStatsTakeFlag(int* argc, char** argv) {
+    bool found = false;
+    int kept = 1;
+    for (int i = 1; i < *argc; i++) {
+        if (strcmp(argv[i], "--stats") == 0)
+            found = true;
+        else
+            argv[kept++] = argv[i];
+    }
+    *argc = kept;
+    argv[kept] = NULL;
+    return found;
+}
+
+// Write the counters and phase timings as one JSON object
+static inline void mstStatsPrintJSON(FILE* out) {
+#ifdef MST_STATS
+    fprintf(out, "{\"enabled\": true, \"findCalls\": %llu, \"findHops\": %llu, \"unions\": %llu, "
+                 "\"edgesScanned\": %llu, \"keyUpdates\": %llu, \"bytesAllocated\": %llu, \"phases\": {",
+            (unsigned long long)mstStats.findCalls, (unsigned long long)mstStats.findHops,
+            (unsigned long long)mstStats.unions, (unsigned long long)mstStats.edgesScanned,
+            (unsigned long long)mstStats.keyUpdates, (unsigned long long)mstStats.bytesAllocated);
+    for (int i = 0; i < mstStats.phaseCount; i++) {
+        fprintf(out, "%s\"%s\": {\"calls\": %llu, \"seconds\": %.9f}", i > 0 ? ", " : "",
+                mstStats.phases[i].name, (unsigned long long)mstStats.phases[i].calls,
+                mstStats.phases[i].seconds);
+    }
+    fprintf(out, "}}\n");
+#else
+    fprintf(out, "{\"enabled\": false}\n");
+#endif
+}
+
+#endif // MST_STATS_H
@@ -0,0 +1,246 @@
+#ifndef PARALLEL_INGEST_H
+#define PARALLEL_INGEST_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "csr_graph.h"
+#include "radix_sort.h"
+
+// Multi-threaded ingest: turning a CSR graph into an edge list and sorting
+// that list by weight. Both stages produce exactly what their sequential
+// versions do (the row-by-row scan order, and sortGraphEdgesByWeight's
+// stable order), so engines fed from here break ties the same way.
+// maxWorkers <= 0 uses every online CPU; small inputs use fewer workers,
+// down to none beyond the calling thread.
+
+// Items each worker should have at least, so thread start-up stays noise
+#ifndef INGEST_MIN_WORK
+#define INGEST_MIN_WORK (1 << 16)
+#endif
+
+static inline int ingestWorkers(size_t work, int maxWorkers) {
+    if (maxWorkers <= 0)
+        maxWorkers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (maxWorkers < 1)
+        maxWorkers = 1;
+    size_t byWork = work / INGEST_MIN_WORK;
+    if (byWork < 1)
+        byWork = 1;
+    return byWork < (size_t)maxWorkers ? (int)byWork : maxWorkers;
+}
+
+// Run fn on each of the count tasks, one thread per task; the calling
+// thread takes task 0
+static inline void ingestRun(void* (*fn)(void*), void* tasks, size_t taskSize, int count) {
+    pthread_t* threads = (pthread_t*)malloc(count * sizeof(pthread_t));
+    bool* started = (bool*)calloc(count, sizeof(bool));
+    for (int t = 1; t < count; t++)
+        started[t] = pthread_create(&threads[t], NULL, fn, (char*)tasks + t * taskSize) == 0;
+    fn(tasks);
+    // Tasks are independent, so one whose thread could not start runs here
+    for (int t = 1; t < count; t++) {
+        if (started[t])
+            pthread_join(threads[t], NULL);
+        else
+            fn((char*)tasks + t * taskSize);
+    }
+    free(started);
+    free(threads);
+}
+
+// One worker's rows of the CSR graph
+typedef struct IngestExtractTask {
+    const CSRGraph* graph;
+    GraphEdge* edges;
+    int begin;          // First vertex
+    int end;            // One past the last vertex
+    int count;          // Edges found in the rows
+    int first;          // Index of the first of them in edges
+} IngestExtractTask;
+
+static void* ingestCount(void* arg) {
+    IngestExtractTask* task = (IngestExtractTask*)arg;
+    const CSRGraph* graph = task->graph;
+    int count = 0;
+    for (int u = task->begin; u < task->end; u++)
+        CSR_FOR_EACH_ARC(graph, u, a)
+            count += u < graph->target[a];
+    task->count = count;
+    return NULL;
+}
+
+static void* ingestFill(void* arg) {
+    IngestExtractTask* task = (IngestExtractTask*)arg;
+    const CSRGraph* graph = task->graph;
+    GraphEdge* out = task->edges + task->first;
+    for (int u = task->begin; u < task->end; u++) {
+        CSR_FOR_EACH_ARC(graph, u, a) {
+            if (u < graph->target[a]) {
+                out->src = u;
+                out->dest = graph->target[a];
+                out->weight = graph->weight[a];
+                out++;
+            }
+        }
+    }
+    return NULL;
+}
+
+// Every undirected edge of the graph once, as (u, v) with u < v, in row
+// order. Rows are split so each worker gets about the same number of arcs;
+// the workers count their edges, a prefix sum places each worker's block
+// and the blocks are filled in parallel. The array has room for at least
+// one edge and is owned by the caller.
+static inline GraphEdge* csrToEdgeArray(const CSRGraph* graph, int* edgeCount, int maxWorkers) {
+    int V = graph->V;
+    size_t arcs = V > 0 ? (size_t)graph->offset[V] : 0;
+    int workers = ingestWorkers(arcs, maxWorkers);
+    IngestExtractTask* tasks = (IngestExtractTask*)malloc(workers * sizeof(IngestExtractTask));
+
+    // Worker t starts at the first row whose arcs begin at or after
+    // t / workers of all arcs
+    int begin = 0;
+    for (int t = 0; t < workers; t++) {
+        size_t target = arcs * (t + 1) / workers;
+        int lo = begin, hi = V;
+        while (t + 1 < workers && lo < hi) {
+            int mid = lo + (hi - lo) / 2;
+            if ((size_t)graph->offset[mid] < target) lo = mid + 1;
+            else hi = mid;
+        }
+        tasks[t].graph = graph;
+        tasks[t].begin = begin;
+        tasks[t].end = t + 1 < workers ? lo : V;
+        begin = tasks[t].end;
+    }
+
+    ingestRun(ingestCount, tasks, sizeof(IngestExtractTask), workers);
+    int E = 0;
+    for (int t = 0; t < workers; t++) {
+        tasks[t].first = E;
+        E += tasks[t].count;
+    }
+    GraphEdge* edges = (GraphEdge*)malloc((E > 0 ? E : 1) * sizeof(GraphEdge));
+    for (int t = 0; t < workers; t++)
+        tasks[t].edges = edges;
+    ingestRun(ingestFill, tasks, sizeof(IngestExtractTask), workers);
+
+    free(tasks);
+    *edgeCount = E;
+    return edges;
+}
+
+// One worker's share of a sort phase: either a chunk to sort, or a slice
+// of the output of one merge round
+typedef struct IngestSortTask {
+    GraphEdge* src;
+    GraphEdge* dst;
+    const size_t* runs;     // Boundaries of the sorted runs in src
+    int runCount;
+    size_t begin;           // Chunk, or output slice, [begin, end)
+    size_t end;
+} IngestSortTask;
+
+static void* ingestSortChunk(void* arg) {
+    IngestSortTask* task = (IngestSortTask*)arg;
+    sortGraphEdgesByWeight(task->src + task->begin, task->end - task->begin);
+    return NULL;
+}
+
+// Number of elements of a among the first k outputs of the stable merge
+// of a (length m) and b (length n), where ties take a first
+static inline size_t ingestCoRank(const GraphEdge* a, size_t m, const GraphEdge* b, size_t n, size_t k) {
+    size_t lo = k > n ? k - n : 0, hi = k < m ? k : m;
+    while (lo < hi) {
+        size_t i = lo + (hi - lo) / 2;
+        if (a[i].weight <= b[k - i - 1].weight) lo = i + 1;
+        else hi = i;
+    }
+    return lo;
+}
+
+// Merge runs 2p and 2p + 1 for every pair p, writing only the outputs
+// that fall in this worker's slice. Co-ranks locate where the slice
+// starts and ends in each pair, so all workers share every round.
+static void* ingestMergeSlice(void* arg) {
+    IngestSortTask* task = (IngestSortTask*)arg;
+    for (int r = 0; r < task->runCount; r += 2) {
+        size_t lo = task->runs[r];
+        size_t mid = task->runs[r + 1];
+        size_t hi = r + 2 <= task->runCount ? task->runs[r + 2] : mid;
+        size_t k0 = task->begin > lo ? task->begin : lo;
+        size_t k1 = task->end < hi ? task->end : hi;
+        if (k0 >= k1) continue;
+
+        const GraphEdge* a = task->src + lo;
+        const GraphEdge* b = task->src + mid;
+        size_t m = mid - lo, n = hi - mid;
+        size_t i = ingestCoRank(a, m, b, n, k0 - lo);
+        size_t j = k0 - lo - i;
+        for (size_t k = k0; k < k1; k++) {
+            if (j >= n || (i < m && a[i].weight <= b[j].weight))
+                task->dst[k] = a[i++];
+            else
+                task->dst[k] = b[j++];
+        }
+    }
+    return NULL;
+}
+
+// Stable sort by weight with the same result as sortGraphEdgesByWeight:
+// every worker radix-sorts one chunk, then rounds of pairwise merges
+// halve the number of runs, each round split evenly across the workers
+static inline void parallelSortEdgesByWeight(GraphEdge* edges, size_t n, int maxWorkers) {
+    int workers = ingestWorkers(n, maxWorkers);
+    if (workers == 1) {
+        sortGraphEdgesByWeight(edges, n);
+        return;
+    }
+
+    IngestSortTask* tasks = (IngestSortTask*)malloc(workers * sizeof(IngestSortTask));
+    size_t* runs = (size_t*)malloc((workers + 1) * sizeof(size_t));
+    for (int t = 0; t <= workers; t++)
+        runs[t] = n * t / workers;
+    for (int t = 0; t < workers; t++) {
+        tasks[t].src = edges;
+        tasks[t].begin = runs[t];
+        tasks[t].end = runs[t + 1];
+    }
+    ingestRun(ingestSortChunk, tasks, sizeof(IngestSortTask), workers);
+
+    GraphEdge* tmp = (GraphEdge*)malloc(n * sizeof(GraphEdge));
+    GraphEdge* src = edges;
+    GraphEdge* dst = tmp;
+    int runCount = workers;
+    while (runCount > 1) {
+        for (int t = 0; t < workers; t++) {
+            tasks[t].src = src;
+            tasks[t].dst = dst;
+            tasks[t].runs = runs;
+            tasks[t].runCount = runCount;
+            tasks[t].begin = n * t / workers;
+            tasks[t].end = n * (t + 1) / workers;
+        }
+        ingestRun(ingestMergeSlice, tasks, sizeof(IngestSortTask), workers);
+
+        // Every merged pair becomes one run
+        int merged = 0;
+        for (int r = 0; r < runCount; r += 2)
+            runs[merged++] = runs[r];
+        runs[merged] = n;
+        runCount = merged;
+        GraphEdge* t = src; src = dst; dst = t;
+    }
+    if (src != edges)
+        memcpy(edges, src, n * sizeof(GraphEdge));
+
+    free(tmp);
+    free(runs);
+    free(tasks);
+}
+
+#endif // PARALLEL_INGEST_H
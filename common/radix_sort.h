@@ -0,0 +1,154 @@
+#ifndef RADIX_SORT_H
+#define RADIX_SORT_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "csr_graph.h"
+
+// LSD radix sorts over signed integer keys, one byte per pass. Every pass
+// is a stable counting sort, so items with equal keys keep their input
+// order and the result is deterministic. Signed keys are mapped to
+// unsigned ones by flipping the sign bit, and passes where every key
+// shares the same byte are skipped.
+
+// Turn a stable counting table into starting offsets. Returns 0 when the
+// pass can be skipped because all n keys fall into one bucket.
+static inline int radixPrefixSums(size_t count[256], size_t n) {
+    size_t sum = 0;
+    for (int d = 0; d < 256; d++) {
+        if (count[d] == n) return 0;
+        size_t c = count[d];
+        count[d] = sum;
+        sum += c;
+    }
+    return 1;
+}
+
+// Stable permutation that sorts 32-bit signed keys ascending:
+// keys[order[0]] <= keys[order[1]] <= ..., equal keys in index order
+static inline void radixSortOrder32(const int32_t* keys, size_t n, int* order) {
+    if (n == 0) return;
+    uint32_t* k = (uint32_t*)malloc(n * sizeof(uint32_t));
+    uint32_t* kTmp = (uint32_t*)malloc(n * sizeof(uint32_t));
+    int* oTmp = (int*)malloc(n * sizeof(int));
+    for (size_t i = 0; i < n; i++) {
+        k[i] = (uint32_t)keys[i] ^ 0x80000000u;
+        order[i] = (int)i;
+    }
+
+    uint32_t* srcK = k; int* srcO = order;
+    uint32_t* dstK = kTmp; int* dstO = oTmp;
+    size_t count[256];
+    for (int shift = 0; shift < 32; shift += 8) {
+        memset(count, 0, sizeof(count));
+        for (size_t i = 0; i < n; i++)
+            count[(srcK[i] >> shift) & 0xFF]++;
+        if (!radixPrefixSums(count, n))
+            continue;
+        for (size_t i = 0; i < n; i++) {
+            size_t dst = count[(srcK[i] >> shift) & 0xFF]++;
+            dstK[dst] = srcK[i];
+            dstO[dst] = srcO[i];
+        }
+        uint32_t* tk = srcK; srcK = dstK; dstK = tk;
+        int* to = srcO; srcO = dstO; dstO = to;
+    }
+    if (srcO != order)
+        memcpy(order, srcO, n * sizeof(int));
+
+    free(k);
+    free(kTmp);
+    free(oTmp);
+}
+
+// Stable permutation that sorts 64-bit signed keys ascending
+static inline void radixSortOrder64(const int64_t* keys, size_t n, int* order) {
+    if (n == 0) return;
+    uint64_t* k = (uint64_t*)malloc(n * sizeof(uint64_t));
+    uint64_t* kTmp = (uint64_t*)malloc(n * sizeof(uint64_t));
+    int* oTmp = (int*)malloc(n * sizeof(int));
+    for (size_t i = 0; i < n; i++) {
+        k[i] = (uint64_t)keys[i] ^ 0x8000000000000000ull;
+        order[i] = (int)i;
+    }
+
+    uint64_t* srcK = k; int* srcO = order;
+    uint64_t* dstK = kTmp; int* dstO = oTmp;
+    size_t count[256];
+    for (int shift = 0; shift < 64; shift += 8) {
+        memset(count, 0, sizeof(count));
+        for (size_t i = 0; i < n; i++)
+            count[(srcK[i] >> shift) & 0xFF]++;
+        if (!radixPrefixSums(count, n))
+            continue;
+        for (size_t i = 0; i < n; i++) {
+            size_t dst = count[(srcK[i] >> shift) & 0xFF]++;
+            dstK[dst] = srcK[i];
+            dstO[dst] = srcO[i];
+        }
+        uint64_t* tk = srcK; srcK = dstK; dstK = tk;
+        int* to = srcO; srcO = dstO; dstO = to;
+    }
+    if (srcO != order)
+        memcpy(order, srcO, n * sizeof(int));
+
+    free(k);
+    free(kTmp);
+    free(oTmp);
+}
+
+// Sort 32-bit signed integers ascending in place, using one scratch buffer
+// of n ints. Short arrays use insertion sort instead.
+static inline void radixSortInt32(int32_t* data, size_t n) {
+    if (n < 32) {
+        for (size_t i = 1; i < n; i++) {
+            int32_t v = data[i];
+            size_t j = i;
+            for (; j > 0 && data[j - 1] > v; j--)
+                data[j] = data[j - 1];
+            data[j] = v;
+        }
+        return;
+    }
+    int32_t* tmp = (int32_t*)malloc(n * sizeof(int32_t));
+    int32_t* src = data;
+    int32_t* dst = tmp;
+    size_t count[256];
+    for (int shift = 0; shift < 32; shift += 8) {
+        memset(count, 0, sizeof(count));
+        for (size_t i = 0; i < n; i++)
+            count[(((uint32_t)src[i] ^ 0x80000000u) >> shift) & 0xFF]++;
+        if (!radixPrefixSums(count, n))
+            continue;
+        for (size_t i = 0; i < n; i++)
+            dst[count[(((uint32_t)src[i] ^ 0x80000000u) >> shift) & 0xFF]++] = src[i];
+        int32_t* t = src; src = dst; dst = t;
+    }
+    if (src != data)
+        memcpy(data, src, n * sizeof(int32_t));
+    free(tmp);
+}
+
+// Stable sort of an edge list by weight: equal-weight edges keep their
+// input order, which makes Kruskal's output deterministic
+static inline void sortGraphEdgesByWeight(GraphEdge* edges, size_t n) {
+    if (n < 2) return;
+    int32_t* keys = (int32_t*)malloc(n * sizeof(int32_t));
+    int* order = (int*)malloc(n * sizeof(int));
+    GraphEdge* sorted = (GraphEdge*)malloc(n * sizeof(GraphEdge));
+
+    for (size_t i = 0; i < n; i++)
+        keys[i] = edges[i].weight;
+    radixSortOrder32(keys, n, order);
+    for (size_t i = 0; i < n; i++)
+        sorted[i] = edges[order[i]];
+    memcpy(edges, sorted, n * sizeof(GraphEdge));
+
+    free(keys);
+    free(order);
+    free(sorted);
+}
+
+#endif // RADIX_SORT_H
@@ -0,0 +1,49 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "../common/csr_graph.h"
+#include "../common/edge_list_text.h"
+#include "../common/graph_file.h"
+
+// Convert a text edge list ("V E" followed by E lines of "u v w") into the
+// binary graph format read by every program. The CSR section is written
+// unless --no-csr is given; "-" reads the text from stdin.
+int main(int argc, char** argv) {
+    bool withCSR = true;
+    const char* input = NULL;
+    const char* output = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--no-csr") == 0)
+            withCSR = false;
+        else if (!input)
+            input = argv[i];
+        else if (!output)
+            output = argv[i];
+    }
+    if (!input || !output) {
+        fprintf(stderr, "Usage: %s [--no-csr] <input.txt|-> <output.mstg>\n", argv[0]);
+        return 2;
+    }
+
+    int V, E;
+    GraphEdge* edges;
+    bool ok = strcmp(input, "-") == 0
+        ? loadEdgeListFd(STDIN_FILENO, &V, &E, &edges)
+        : loadEdgeListFile(input, &V, &E, &edges);
+    if (!ok) {
+        fprintf(stderr, "Could not read a graph from %s\n", input);
+        return 1;
+    }
+
+    if (!writeGraphFile(output, V, edges, E, withCSR)) {
+        fprintf(stderr, "Could not write %s\n", output);
+        free(edges);
+        return 1;
+    }
+    printf("Wrote %d vertices and %d edges%s to %s\n", V, E, withCSR ? " with CSR" : "", output);
+
+    free(edges);
+    return 0;
+}
@@ -1,96 +1,1330 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <limits.h>
+#include <stdbool.h>
+#include <string.h>
 
-// Define an edge
-typedef struct Edge {
-    int to;
-    int weight;
-    struct Edge* next;
-} Edge;
-
-// Add edge to adjacency list
-void addEdge(Edge** adjList, int from, int to, int weight) {
-    Edge* newEdge = malloc(sizeof(Edge));
-    newEdge->to = to;
-    newEdge->weight = weight;
-    newEdge->next = adjList[from];
-    adjList[from] = newEdge;
-}
+#include "../common/csr_graph.h"
+#include "../common/radix_sort.h"
+#include "../common/dsu.h"
+#include "../common/graph_file.h"
 
 // Find the best edge from new vertex to MST
-int findBestEdge(int mstSize, Edge** adjList, int newVertex, int* toNode, int* bestWeight) {
+int findBestEdge(int mstSize, const CSRGraph* graph, int newVertex, int* toNode, int* bestWeight) {
     // Initialize best weight to maximum possible value
     *bestWeight = INT_MAX;
     *toNode = -1;
     
     // Look through all edges from the new vertex
-    Edge* curr = adjList[newVertex];
-    while (curr != NULL) {
+    CSR_FOR_EACH_ARC(graph, newVertex, a) {
+        int to = graph->target[a];
         // Check if this edge connects to a vertex in the MST and has smaller weight
-        if (curr->to < mstSize && curr->weight < *bestWeight) {
-            *bestWeight = curr->weight;
-            *toNode = curr->to;
+        if (to < mstSize && graph->weight[a] < *bestWeight) {
+            *bestWeight = graph->weight[a];
+            *toNode = to;
         }
-        curr = curr->next;
     }
     
     // Return true if we found an edge to the MST
     return *toNode != -1;
 }
 
-int main() {
+// Print every vertex of a graph together with its incident edges
+void printGraph(const CSRGraph* graph) {
+    for (int i = 0; i < graph->V; i++) {
+        printf("Vertex %d:", i);
+        CSR_FOR_EACH_ARC(graph, i, a) {
+            printf(" -> (%d, %d)", graph->target[a], graph->weight[a]);
+        }
+        printf("\n");
+    }
+}
+
+// Tree edges gained and lost by one MST update
+typedef struct MSTDelta {
+    GraphEdge* added;
+    int addedCount;
+    GraphEdge* removed;
+    int removedCount;
+} MSTDelta;
+
+// MST kept as a rooted spanning forest: parent[v] is -1 for a root,
+// otherwise (v, parent[v]) is a tree edge of weight parentWeight[v]
+typedef struct IncrementalMST {
+    int V;              // Number of vertices
+    int capacity;       // Allocated length of parent/parentWeight
+    int* parent;
+    int* parentWeight;
+} IncrementalMST;
+
+void freeMSTDelta(MSTDelta* delta) {
+    free(delta->added);
+    free(delta->removed);
+    delta->added = delta->removed = NULL;
+    delta->addedCount = delta->removedCount = 0;
+}
+
+// Make room for at least V vertices
+static void reserveVertices(IncrementalMST* mst, int V) {
+    if (V <= mst->capacity) return;
+    int capacity = mst->capacity > 0 ? mst->capacity : 4;
+    while (capacity < V)
+        capacity *= 2;
+    mst->parent = (int*)realloc(mst->parent, capacity * sizeof(int));
+    mst->parentWeight = (int*)realloc(mst->parentWeight, capacity * sizeof(int));
+    mst->capacity = capacity;
+}
+
+// Re-root the forest formed by edges over mst->V vertices with a BFS
+// from every vertex not reached yet, in vertex order
+static void rootForest(IncrementalMST* mst, const GraphEdge* edges, int count) {
+    int V = mst->V;
+    CSRGraph* tree = buildCSRGraph(V, edges, count);
+    int* queue = (int*)malloc((V > 0 ? V : 1) * sizeof(int));
+    char* seen = (char*)calloc(V > 0 ? V : 1, 1);
+    
+    for (int r = 0; r < V; r++) {
+        if (seen[r]) continue;
+        int head = 0, tail = 0;
+        seen[r] = 1;
+        mst->parent[r] = -1;
+        mst->parentWeight[r] = 0;
+        queue[tail++] = r;
+        while (head < tail) {
+            int x = queue[head++];
+            CSR_FOR_EACH_ARC(tree, x, a) {
+                int y = tree->target[a];
+                if (seen[y]) continue;
+                seen[y] = 1;
+                mst->parent[y] = x;
+                mst->parentWeight[y] = tree->weight[a];
+                queue[tail++] = y;
+            }
+        }
+    }
+    
+    free(queue);
+    free(seen);
+    freeCSRGraph(tree);
+}
+
+// Create the updater from the edges of an existing MST (or spanning forest)
+IncrementalMST* createIncrementalMST(int V, const GraphEdge* treeEdges, int count) {
+    IncrementalMST* mst = (IncrementalMST*)calloc(1, sizeof(IncrementalMST));
+    mst->V = V;
+    reserveVertices(mst, V);
+    rootForest(mst, treeEdges, count);
+    return mst;
+}
+
+void freeIncrementalMST(IncrementalMST* mst) {
+    free(mst->parent);
+    free(mst->parentWeight);
+    free(mst);
+}
+
+// Copy the current tree edges into edges (room for V - 1) and return their count
+int getTreeEdges(const IncrementalMST* mst, GraphEdge* edges) {
+    int count = 0;
+    for (int v = 0; v < mst->V; v++) {
+        if (mst->parent[v] == -1) continue;
+        edges[count].src = mst->parent[v];
+        edges[count].dest = v;
+        edges[count].weight = mst->parentWeight[v];
+        count++;
+    }
+    return count;
+}
+
+// Order candidate edges of insertVertex by (weight, id)
+static bool candidateHeavier(const IncrementalMST* mst, const int* newWeight, int a, int b) {
+    int V = mst->V;
+    int wa = a < V ? mst->parentWeight[a] : newWeight[a - V];
+    int wb = b < V ? mst->parentWeight[b] : newWeight[b - V];
+    return wa > wb || (wa == wb && a > b);
+}
+
+// Add a new vertex with k incident edges to existing vertices and update the
+// MST exactly in O(V + k). The new vertex gets id mst->V and is returned.
+//
+// Candidates are tree edges (id = child vertex) and new edges (id = V + j).
+// Walking the tree bottom-up, best[v] is the heaviest edge on the path from
+// the new vertex down to v in the MST of the part seen so far. Hooking
+// child c under v closes a cycle through best[c], edge (c, v) and best[v];
+// its heaviest edge is dropped and the lighter path maximum moves up.
+int insertVertex(IncrementalMST* mst, const GraphEdge* incident, int k, MSTDelta* delta) {
+    int V = mst->V;
+    int x = V;
+    
+    // Order vertices parents-first: count children, then BFS from the roots
+    int* childStart = (int*)calloc(V + 1, sizeof(int));
+    int* children = (int*)malloc((V > 0 ? V : 1) * sizeof(int));
+    int* order = (int*)malloc((V > 0 ? V : 1) * sizeof(int));
+    for (int v = 0; v < V; v++)
+        if (mst->parent[v] != -1)
+            childStart[mst->parent[v] + 1]++;
+    for (int v = 0; v < V; v++)
+        childStart[v + 1] += childStart[v];
+    int* cursor = (int*)malloc((V > 0 ? V : 1) * sizeof(int));
+    memcpy(cursor, childStart, V * sizeof(int));
+    int n = 0;
+    for (int v = 0; v < V; v++) {
+        if (mst->parent[v] != -1)
+            children[cursor[mst->parent[v]]++] = v;
+        else
+            order[n++] = v;
+    }
+    for (int i = 0; i < n; i++)
+        for (int c = childStart[order[i]]; c < childStart[order[i] + 1]; c++)
+            order[n++] = children[c];
+    free(cursor);
+    free(children);
+    free(childStart);
+    
+    // Candidate weights and ordering; ties drop new edges before tree edges
+    int* newWeight = (int*)malloc((k > 0 ? k : 1) * sizeof(int));
+    int* newTarget = (int*)malloc((k > 0 ? k : 1) * sizeof(int));
+    bool* dropped = (bool*)calloc(V + k, sizeof(bool));
+    int* best = (int*)malloc((V > 0 ? V : 1) * sizeof(int));
+    
+    for (int v = 0; v < V; v++)
+        best[v] = -1;
+    for (int j = 0; j < k; j++) {
+        int t = incident[j].src == x ? incident[j].dest : incident[j].src;
+        newTarget[j] = t;
+        newWeight[j] = incident[j].weight;
+        if (t < 0 || t >= V) {
+            dropped[V + j] = true;
+            continue;
+        }
+        // Parallel edges to the same vertex: only the lightest can survive
+        int id = V + j;
+        if (best[t] == -1) {
+            best[t] = id;
+        } else if (candidateHeavier(mst, newWeight, best[t], id)) {
+            dropped[best[t]] = true;
+            best[t] = id;
+        } else {
+            dropped[id] = true;
+        }
+    }
+    
+    // Merge every subtree into its parent, deepest vertices first
+    for (int i = V - 1; i >= 0; i--) {
+        int c = order[i];
+        int v = mst->parent[c];
+        if (v == -1 || best[c] == -1) continue;
+        
+        // Heavier of the child's path maximum and the tree edge (c, v)
+        int h = candidateHeavier(mst, newWeight, best[c], c) ? best[c] : c;
+        if (best[v] == -1) {
+            best[v] = h; // No cycle yet: the path to v now runs through c
+        } else if (candidateHeavier(mst, newWeight, best[v], h)) {
+            dropped[best[v]] = true;
+            best[v] = h;
+        } else {
+            dropped[h] = true;
+        }
+    }
+    
+    // Record the delta and the new edge set
+    delta->added = (GraphEdge*)malloc((k > 0 ? k : 1) * sizeof(GraphEdge));
+    delta->removed = (GraphEdge*)malloc((k > 0 ? k : 1) * sizeof(GraphEdge));
+    delta->addedCount = delta->removedCount = 0;
+    GraphEdge* edges = (GraphEdge*)malloc((V + k) * sizeof(GraphEdge));
+    int count = 0;
+    for (int v = 0; v < V; v++) {
+        if (mst->parent[v] == -1) continue;
+        GraphEdge e = {mst->parent[v], v, mst->parentWeight[v]};
+        if (dropped[v])
+            delta->removed[delta->removedCount++] = e;
+        else
+            edges[count++] = e;
+    }
+    for (int j = 0; j < k; j++) {
+        if (dropped[V + j]) continue;
+        GraphEdge e = {x, newTarget[j], newWeight[j]};
+        delta->added[delta->addedCount++] = e;
+        edges[count++] = e;
+    }
+    
+    mst->V = V + 1;
+    reserveVertices(mst, mst->V);
+    rootForest(mst, edges, count);
+    
+    free(edges);
+    free(order);
+    free(best);
+    free(dropped);
+    free(newWeight);
+    free(newTarget);
+    
+    return x;
+}
+
+// Add count new vertices (ids mst->V .. mst->V + count - 1) together with
+// their m incident edges, which may join new vertices to old ones or to
+// each other. Runs one Kruskal pass over only the current tree edges plus
+// the new edges, so the cost depends on V and the batch, not on the full
+// graph. Returns the id of the first new vertex.
+int insertVertices(IncrementalMST* mst, int count, const GraphEdge* incident, int m, MSTDelta* delta) {
+    int oldV = mst->V;
+    int V = oldV + count;
+    
+    // Current tree edges first, so they win ties against new edges
+    GraphEdge* edges = (GraphEdge*)malloc((oldV + m > 0 ? oldV + m : 1) * sizeof(GraphEdge));
+    int treeCount = getTreeEdges(mst, edges);
+    int total = treeCount;
+    for (int j = 0; j < m; j++) {
+        if (incident[j].src < 0 || incident[j].src >= V ||
+            incident[j].dest < 0 || incident[j].dest >= V) continue;
+        edges[total++] = incident[j];
+    }
+    
+    // Remember which sorted edges were tree edges via a stable sort of ids
+    int32_t* keys = (int32_t*)malloc((total > 0 ? total : 1) * sizeof(int32_t));
+    int* order = (int*)malloc((total > 0 ? total : 1) * sizeof(int));
+    for (int i = 0; i < total; i++)
+        keys[i] = edges[i].weight;
+    radixSortOrder32(keys, total, order);
+    
+    DSU* sets = createDSU(V);
+    bool* kept = (bool*)calloc(total > 0 ? total : 1, sizeof(bool));
+    int treeSize = 0;
+    for (int i = 0; i < total && treeSize < V - 1; i++) {
+        int e = order[i];
+        if (dsuUnion(sets, edges[e].src, edges[e].dest)) {
+            kept[e] = true;
+            treeSize++;
+        }
+    }
+    
+    delta->added = (GraphEdge*)malloc((m > 0 ? m : 1) * sizeof(GraphEdge));
+    delta->removed = (GraphEdge*)malloc((treeCount > 0 ? treeCount : 1) * sizeof(GraphEdge));
+    delta->addedCount = delta->removedCount = 0;
+    GraphEdge* tree = (GraphEdge*)malloc((treeSize > 0 ? treeSize : 1) * sizeof(GraphEdge));
+    int n = 0;
+    for (int e = 0; e < total; e++) {
+        if (kept[e])
+            tree[n++] = edges[e];
+        if (e < treeCount && !kept[e])
+            delta->removed[delta->removedCount++] = edges[e];
+        else if (e >= treeCount && kept[e])
+            delta->added[delta->addedCount++] = edges[e];
+    }
+    
+    mst->V = V;
+    reserveVertices(mst, V);
+    rootForest(mst, tree, n);
+    
+    free(tree);
+    free(kept);
+    freeDSU(sets);
+    free(order);
+    free(keys);
+    free(edges);
+    
+    return oldV;
+}
+
+// Print the edges gained and lost by an update
+void printDelta(const MSTDelta* delta) {
+    for (int i = 0; i < delta->addedCount; i++)
+        printf("  + (%d - %d) weight %d\n", delta->added[i].src, delta->added[i].dest, delta->added[i].weight);
+    for (int i = 0; i < delta->removedCount; i++)
+        printf("  - (%d - %d) weight %d\n", delta->removed[i].src, delta->removed[i].dest, delta->removed[i].weight);
+}
+
+// Fully dynamic MST
+// The tree is stored in a link-cut forest where every edge is its own node
+// between its two endpoints, so a path-maximum query on the forest returns
+// the heaviest tree edge between two vertices. Insertions and weight
+// decreases use it to swap out the heaviest edge on the cycle they close.
+//
+// Replacements for a removed tree edge come from the level structure of
+// Holm, de Lichtenberg and Thorup. Every edge has a level below log2(V).
+// Level i keeps an Euler-tour forest of the tree edges of level >= i, whose
+// trees never exceed V / 2^i vertices, and every vertex keeps its non-tree
+// edges of level i ordered by (weight, id). A non-tree edge of level i
+// always joins two vertices of one level-i tree, so after a cut the edges
+// crossing it at level i all touch the smaller half of that tree. Each
+// level scans them lightest first, moving edges that stay inside the half
+// up one level together with the half's tree edges, until one crosses.
+//
+// Unlike HDT's decremental algorithm the search cannot stop at the first
+// level with a candidate: insertions enter at level 0 and may leave a
+// lighter replacement below a heavier one. Every level is searched, the
+// lightest candidate wins, and crossing edges of higher levels are moved
+// down to its level.
+//
+// Cost: insertions, weight decreases and deletions of non-tree edges take
+// O(log^2 V) amortized. Deleting or raising a tree edge takes O(log^2 V)
+// plus O(log V) for every edge promoted or moved down. Without moves down
+// an edge is promoted at most log2(V) times, which is HDT's amortized
+// bound, but nothing limits the moves down. A mix of insertions and
+// deletions can therefore make single deletions cost time linear in the
+// number of edges, so this is not a polylogarithmic amortized bound. A
+// proven bound needs HDT's reduction from decremental to fully dynamic
+// MSF, which is not implemented here.
+
+typedef struct DynamicEdge {
+    int u;
+    int v;
+    int weight;
+    int level;          // HDT level
+    int slot;           // Euler-tour arc block while a tree edge, else -1
+    bool alive;         // False once deleted; ids are never reused
+    bool inTree;        // Currently an MST edge
+} DynamicEdge;
+
+#define TOUR_SELF_MARK 1        // Arc of a tree edge whose level is this tour's level
+#define TOUR_SUBTREE_MARK 2     // Some node in the splay subtree has TOUR_SELF_MARK
+
+typedef struct DynamicMST {
+    int V;                  // Number of vertices
+    DynamicEdge* edges;     // Every edge ever inserted, indexed by id
+    int edgeCount;
+    int edgeCapacity;
+    
+    // Link-cut forest over V vertex nodes followed by one node per edge id
+    int (*child)[2];        // Splay-tree children
+    int* up;                // Splay parent, or path-parent at a splay root
+    unsigned char* flip;    // Pending subtree reversal
+    int* heaviest;          // Heaviest edge node in the splay subtree, -1 if none
+    int* stack;             // Scratch for pushing reversals down before a splay
+    
+    // Euler-tour forests as splay trees: node level * V + v is vertex v at
+    // that level, followed by two arc nodes per level for each tree slot
+    int levels;
+    int (*tourChild)[2];
+    int* tourUp;
+    int* tourSize;          // Vertex nodes in the splay subtree
+    int* tourOwn;           // Lightest non-tree edge at a vertex node, -1 if none
+    int* tourBest;          // Lightest tourOwn in the splay subtree
+    unsigned char* tourMark;
+    int* slotEdge;          // Tree edge holding each arc block
+    int* freeSlots;
+    int freeSlotCount;
+    
+    // Treap of the level-i non-tree edges at vertex v, rooted at
+    // incidentRoot[i * V + v]; node 2 * id + side is the u or v end of id
+    int* incidentRoot;
+    int (*incidentChild)[2];
+    unsigned* incidentPriority;
+    unsigned seed;
+    
+    // Scratch for one cut: the smaller half searched at each level, whether
+    // that search stopped before running out of edges, and the non-tree
+    // edges taken out to be promoted or moved down
+    int* cutSide;
+    unsigned char* cutOpen;
+    int* moved;
+    int movedCount;
+    int* demoted;
+    int demotedCount;
+} DynamicMST;
+
+// Order edge nodes by (weight, id); -1 means no edge
+static bool dynHeavier(const DynamicMST* mst, int a, int b) {
+    if (b == -1) return a != -1;
+    if (a == -1) return false;
+    int wa = mst->edges[a - mst->V].weight;
+    int wb = mst->edges[b - mst->V].weight;
+    return wa > wb || (wa == wb && a > b);
+}
+
+// Order edge ids by (weight, id); -1 means no edge and loses to any edge
+static bool dynLighter(const DynamicMST* mst, int a, int b) {
+    if (a == -1) return false;
+    if (b == -1) return true;
+    int wa = mst->edges[a].weight;
+    int wb = mst->edges[b].weight;
+    return wa < wb || (wa == wb && a < b);
+}
+
+static bool lctIsRoot(const DynamicMST* mst, int x) {
+    int p = mst->up[x];
+    return p == -1 || (mst->child[p][0] != x && mst->child[p][1] != x);
+}
+
+static void lctPush(DynamicMST* mst, int x) {
+    if (!mst->flip[x]) return;
+    int l = mst->child[x][0], r = mst->child[x][1];
+    mst->child[x][0] = r;
+    mst->child[x][1] = l;
+    if (l != -1) mst->flip[l] ^= 1;
+    if (r != -1) mst->flip[r] ^= 1;
+    mst->flip[x] = 0;
+}
+
+static void lctPull(DynamicMST* mst, int x) {
+    int best = x >= mst->V ? x : -1;
+    for (int d = 0; d < 2; d++) {
+        int c = mst->child[x][d];
+        if (c != -1 && dynHeavier(mst, mst->heaviest[c], best))
+            best = mst->heaviest[c];
+    }
+    mst->heaviest[x] = best;
+}
+
+static void lctRotate(DynamicMST* mst, int x) {
+    int p = mst->up[x], g = mst->up[p];
+    int d = mst->child[p][1] == x;
+    if (!lctIsRoot(mst, p))
+        mst->child[g][mst->child[g][1] == p] = x;
+    mst->up[x] = g;
+    mst->child[p][d] = mst->child[x][!d];
+    if (mst->child[x][!d] != -1)
+        mst->up[mst->child[x][!d]] = p;
+    mst->child[x][!d] = p;
+    mst->up[p] = x;
+    lctPull(mst, p);
+    lctPull(mst, x);
+}
+
+static void lctSplay(DynamicMST* mst, int x) {
+    // Push pending reversals from the splay root down to x
+    int top = 0;
+    mst->stack[top++] = x;
+    for (int y = x; !lctIsRoot(mst, y); y = mst->up[y])
+        mst->stack[top++] = mst->up[y];
+    while (top > 0)
+        lctPush(mst, mst->stack[--top]);
+    
+    while (!lctIsRoot(mst, x)) {
+        int p = mst->up[x];
+        if (!lctIsRoot(mst, p)) {
+            int g = mst->up[p];
+            bool zigzig = (mst->child[g][0] == p) == (mst->child[p][0] == x);
+            lctRotate(mst, zigzig ? p : x);
+        }
+        lctRotate(mst, x);
+    }
+}
+
+// Make the root-to-x path preferred and splay x to the top of it
+static void lctAccess(DynamicMST* mst, int x) {
+    for (int last = -1, y = x; y != -1; last = y, y = mst->up[y]) {
+        lctSplay(mst, y);
+        mst->child[y][1] = last;
+        lctPull(mst, y);
+    }
+    lctSplay(mst, x);
+}
+
+static void lctMakeRoot(DynamicMST* mst, int x) {
+    lctAccess(mst, x);
+    mst->flip[x] ^= 1;
+}
+
+static int lctFindRoot(DynamicMST* mst, int x) {
+    lctAccess(mst, x);
+    for (;;) {
+        lctPush(mst, x);
+        if (mst->child[x][0] == -1) break;
+        x = mst->child[x][0];
+    }
+    lctSplay(mst, x);
+    return x;
+}
+
+static void lctLink(DynamicMST* mst, int x, int y) {
+    lctMakeRoot(mst, x);
+    mst->up[x] = y;
+}
+
+static void lctCut(DynamicMST* mst, int x, int y) {
+    lctMakeRoot(mst, x);
+    lctAccess(mst, y);
+    // x is now the only node left of y on the path
+    mst->child[y][0] = -1;
+    mst->up[x] = -1;
+    lctPull(mst, y);
+}
+
+// Heaviest edge node on the tree path between vertices x and y
+static int lctPathMax(DynamicMST* mst, int x, int y) {
+    lctMakeRoot(mst, x);
+    lctAccess(mst, y);
+    return mst->heaviest[y];
+}
+
+// Initialise link-cut node n as an isolated node
+static void lctInitNode(DynamicMST* mst, int n) {
+    mst->child[n][0] = mst->child[n][1] = -1;
+    mst->up[n] = -1;
+    mst->flip[n] = 0;
+    mst->heaviest[n] = n >= mst->V ? n : -1;
+}
+
+static bool tourIsVertex(const DynamicMST* mst, int x) {
+    return x < mst->levels * mst->V;
+}
+
+// Arc node dir (0 or 1) of tree slot s at a level
+static int tourArc(const DynamicMST* mst, int s, int level, int dir) {
+    return mst->levels * mst->V + (s * mst->levels + level) * 2 + dir;
+}
+
+static int tourArcEdge(const DynamicMST* mst, int x) {
+    return mst->slotEdge[(x - mst->levels * mst->V) / (2 * mst->levels)];
+}
+
+static void tourPull(DynamicMST* mst, int x) {
+    int size = tourIsVertex(mst, x) ? 1 : 0;
+    int best = mst->tourOwn[x];
+    unsigned char self = mst->tourMark[x] & TOUR_SELF_MARK;
+    bool marked = self != 0;
+    for (int d = 0; d < 2; d++) {
+        int c = mst->tourChild[x][d];
+        if (c == -1) continue;
+        size += mst->tourSize[c];
+        if (dynLighter(mst, mst->tourBest[c], best))
+            best = mst->tourBest[c];
+        if (mst->tourMark[c] & TOUR_SUBTREE_MARK)
+            marked = true;
+    }
+    mst->tourSize[x] = size;
+    mst->tourBest[x] = best;
+    mst->tourMark[x] = self | (marked ? TOUR_SUBTREE_MARK : 0);
+}
+
+static void tourRotate(DynamicMST* mst, int x) {
+    int p = mst->tourUp[x], g = mst->tourUp[p];
+    int dir = mst->tourChild[p][1] == x;
+    int b = mst->tourChild[x][!dir];
+    mst->tourChild[p][dir] = b;
+    if (b != -1) mst->tourUp[b] = p;
+    mst->tourChild[x][!dir] = p;
+    mst->tourUp[p] = x;
+    mst->tourUp[x] = g;
+    if (g != -1)
+        mst->tourChild[g][mst->tourChild[g][1] == p] = x;
+    tourPull(mst, p);
+    tourPull(mst, x);
+}
+
+// Bring x to the root of its tour's splay tree
+static void tourSplay(DynamicMST* mst, int x) {
+    while (mst->tourUp[x] != -1) {
+        int p = mst->tourUp[x], g = mst->tourUp[p];
+        if (g != -1) {
+            bool zigzig = (mst->tourChild[g][1] == p) == (mst->tourChild[p][1] == x);
+            tourRotate(mst, zigzig ? p : x);
+        }
+        tourRotate(mst, x);
+    }
+}
+
+// Concatenate the tours rooted at a and b; returns the new root
+static int tourJoin(DynamicMST* mst, int a, int b) {
+    if (a == -1) return b;
+    if (b == -1) return a;
+    while (mst->tourChild[a][1] != -1)
+        a = mst->tourChild[a][1];
+    tourSplay(mst, a);
+    mst->tourChild[a][1] = b;
+    mst->tourUp[b] = a;
+    tourPull(mst, a);
+    return a;
+}
+
+// Rotate x's tour so that it starts at x
+static void tourReroot(DynamicMST* mst, int x) {
+    tourSplay(mst, x);
+    int l = mst->tourChild[x][0];
+    if (l == -1) return;
+    mst->tourChild[x][0] = -1;
+    mst->tourUp[l] = -1;
+    tourPull(mst, x);
+    tourJoin(mst, x, l);
+}
+
+static void tourInitNode(DynamicMST* mst, int x, unsigned char mark) {
+    mst->tourChild[x][0] = mst->tourChild[x][1] = -1;
+    mst->tourUp[x] = -1;
+    mst->tourOwn[x] = -1;
+    mst->tourMark[x] = mark;
+    tourPull(mst, x);
+}
+
+// Splice tree edge id into the tour of its level-i trees
+static void tourLink(DynamicMST* mst, int id, int level) {
+    DynamicEdge* e = &mst->edges[id];
+    int x = level * mst->V + e->u;
+    int y = level * mst->V + e->v;
+    int a = tourArc(mst, e->slot, level, 0);
+    tourInitNode(mst, a, level == e->level ? TOUR_SELF_MARK : 0);
+    tourInitNode(mst, a + 1, 0);
+    tourReroot(mst, x);
+    tourReroot(mst, y);
+    tourSplay(mst, x);
+    tourSplay(mst, y);
+    tourJoin(mst, tourJoin(mst, tourJoin(mst, x, a), y), a + 1);
+}
+
+// Split the level-i tour at the two arcs of tree edge id
+static void tourCut(DynamicMST* mst, int id, int level) {
+    int a = tourArc(mst, mst->edges[id].slot, level, 0);
+    int b = a + 1;
+    tourSplay(mst, a);
+    int left = mst->tourChild[a][0], right = mst->tourChild[a][1];
+    if (left != -1) mst->tourUp[left] = -1;
+    if (right != -1) mst->tourUp[right] = -1;
+    
+    // The part between the two arcs is one side, the rest the other
+    tourSplay(mst, b);
+    bool afterA = right != -1 && (right == b || mst->tourUp[right] != -1);
+    int before = mst->tourChild[b][0], after = mst->tourChild[b][1];
+    if (before != -1) mst->tourUp[before] = -1;
+    if (after != -1) mst->tourUp[after] = -1;
+    if (afterA)
+        tourJoin(mst, left, after);
+    else
+        tourJoin(mst, before, right);
+}
+
+static bool tourConnected(DynamicMST* mst, int level, int u, int v) {
+    int x = level * mst->V + u;
+    int y = level * mst->V + v;
+    if (x == y) return true;
+    tourSplay(mst, x);
+    tourSplay(mst, y);
+    return mst->tourUp[x] != -1;
+}
+
+// Vertices in v's level-i tree
+static int tourTreeSize(DynamicMST* mst, int level, int v) {
+    int x = level * mst->V + v;
+    tourSplay(mst, x);
+    return mst->tourSize[x];
+}
+
+// Lightest level-i non-tree edge touching v's level-i tree, or -1
+static int tourTreeBest(DynamicMST* mst, int level, int v) {
+    int x = level * mst->V + v;
+    tourSplay(mst, x);
+    return mst->tourBest[x];
+}
+
+// A tree edge of exactly this level in v's level-i tree, or -1
+static int tourFindMarked(DynamicMST* mst, int level, int v) {
+    int x = level * mst->V + v;
+    tourSplay(mst, x);
+    if (!(mst->tourMark[x] & TOUR_SUBTREE_MARK)) return -1;
+    while (!(mst->tourMark[x] & TOUR_SELF_MARK)) {
+        int l = mst->tourChild[x][0];
+        x = l != -1 && (mst->tourMark[l] & TOUR_SUBTREE_MARK) ? l : mst->tourChild[x][1];
+    }
+    tourSplay(mst, x);
+    return tourArcEdge(mst, x);
+}
+
+// Split treap t into edges lighter than key and the rest
+static void incidentSplit(DynamicMST* mst, int t, int key, int* lo, int* hi) {
+    if (t == -1) {
+        *lo = *hi = -1;
+    } else if (dynLighter(mst, t >> 1, key)) {
+        *lo = t;
+        incidentSplit(mst, mst->incidentChild[t][1], key, &mst->incidentChild[t][1], hi);
+    } else {
+        *hi = t;
+        incidentSplit(mst, mst->incidentChild[t][0], key, lo, &mst->incidentChild[t][0]);
+    }
+}
+
+static int incidentMerge(DynamicMST* mst, int a, int b) {
+    if (a == -1) return b;
+    if (b == -1) return a;
+    if (mst->incidentPriority[a] > mst->incidentPriority[b]) {
+        mst->incidentChild[a][1] = incidentMerge(mst, mst->incidentChild[a][1], b);
+        return a;
+    }
+    mst->incidentChild[b][0] = incidentMerge(mst, a, mst->incidentChild[b][0]);
+    return b;
+}
+
+static int incidentInsert(DynamicMST* mst, int t, int n) {
+    if (t == -1) return n;
+    if (mst->incidentPriority[n] > mst->incidentPriority[t]) {
+        incidentSplit(mst, t, n >> 1, &mst->incidentChild[n][0], &mst->incidentChild[n][1]);
+        return n;
+    }
+    int d = dynLighter(mst, t >> 1, n >> 1);
+    mst->incidentChild[t][d] = incidentInsert(mst, mst->incidentChild[t][d], n);
+    return t;
+}
+
+static int incidentRemove(DynamicMST* mst, int t, int n) {
+    if (t == n)
+        return incidentMerge(mst, mst->incidentChild[n][0], mst->incidentChild[n][1]);
+    int d = dynLighter(mst, t >> 1, n >> 1);
+    mst->incidentChild[t][d] = incidentRemove(mst, mst->incidentChild[t][d], n);
+    return t;
+}
+
+// Refresh the lightest non-tree edge stored at vertex node (level, v)
+static void tourRefreshVertex(DynamicMST* mst, int level, int v) {
+    int x = level * mst->V + v;
+    int t = mst->incidentRoot[x];
+    while (t != -1 && mst->incidentChild[t][0] != -1)
+        t = mst->incidentChild[t][0];
+    tourSplay(mst, x);
+    mst->tourOwn[x] = t == -1 ? -1 : t >> 1;
+    tourPull(mst, x);
+}
+
+// File non-tree edge id under both endpoints at a level
+static void dynAddNonTree(DynamicMST* mst, int id, int level) {
+    DynamicEdge* e = &mst->edges[id];
+    e->level = level;
+    if (e->u == e->v) return;
+    for (int side = 0; side < 2; side++) {
+        int w = side ? e->v : e->u;
+        int n = 2 * id + side;
+        mst->incidentChild[n][0] = mst->incidentChild[n][1] = -1;
+        mst->incidentRoot[level * mst->V + w] = incidentInsert(mst, mst->incidentRoot[level * mst->V + w], n);
+        tourRefreshVertex(mst, level, w);
+    }
+}
+
+// Take non-tree edge id out of its level; its weight must be the one it was filed with
+static void dynRemoveNonTree(DynamicMST* mst, int id) {
+    DynamicEdge* e = &mst->edges[id];
+    if (e->u == e->v) return;
+    for (int side = 0; side < 2; side++) {
+        int w = side ? e->v : e->u;
+        int* root = &mst->incidentRoot[e->level * mst->V + w];
+        *root = incidentRemove(mst, *root, 2 * id + side);
+        tourRefreshVertex(mst, e->level, w);
+    }
+}
+
+static void dynLinkEdge(DynamicMST* mst, int id) {
+    DynamicEdge* e = &mst->edges[id];
+    int node = mst->V + id;
+    lctInitNode(mst, node);
+    lctLink(mst, e->u, node);
+    lctLink(mst, node, e->v);
+    e->slot = mst->freeSlots[--mst->freeSlotCount];
+    mst->slotEdge[e->slot] = id;
+    for (int i = 0; i <= e->level; i++)
+        tourLink(mst, id, i);
+    e->inTree = true;
+}
+
+static void dynCutEdge(DynamicMST* mst, int id) {
+    DynamicEdge* e = &mst->edges[id];
+    int node = mst->V + id;
+    lctCut(mst, e->u, node);
+    lctCut(mst, node, e->v);
+    for (int i = 0; i <= e->level; i++)
+        tourCut(mst, id, i);
+    mst->freeSlots[mst->freeSlotCount++] = e->slot;
+    e->slot = -1;
+    e->inTree = false;
+}
+
+// Move tree edge id up one level
+static void dynPromoteTreeEdge(DynamicMST* mst, int id) {
+    DynamicEdge* e = &mst->edges[id];
+    int a = tourArc(mst, e->slot, e->level, 0);
+    tourSplay(mst, a);
+    mst->tourMark[a] &= ~TOUR_SELF_MARK;
+    tourPull(mst, a);
+    e->level++;
+    tourLink(mst, id, e->level);
+}
+
+static void deltaInit(MSTDelta* delta) {
+    delta->added = (GraphEdge*)malloc(sizeof(GraphEdge));
+    delta->removed = (GraphEdge*)malloc(sizeof(GraphEdge));
+    delta->addedCount = delta->removedCount = 0;
+}
+
+static GraphEdge dynEdgeAsGraphEdge(const DynamicMST* mst, int id) {
+    GraphEdge e = {mst->edges[id].u, mst->edges[id].v, mst->edges[id].weight};
+    return e;
+}
+
+// Grow the per-edge arrays to the current edge capacity
+static void dynReserveEdges(DynamicMST* mst) {
+    int cap = mst->edgeCapacity;
+    int nodes = mst->V + cap;
+    mst->edges = (DynamicEdge*)realloc(mst->edges, cap * sizeof(DynamicEdge));
+    mst->child = (int (*)[2])realloc(mst->child, nodes * sizeof(*mst->child));
+    mst->up = (int*)realloc(mst->up, nodes * sizeof(int));
+    mst->flip = (unsigned char*)realloc(mst->flip, nodes);
+    mst->heaviest = (int*)realloc(mst->heaviest, nodes * sizeof(int));
+    mst->stack = (int*)realloc(mst->stack, nodes * sizeof(int));
+    mst->incidentChild = (int (*)[2])realloc(mst->incidentChild, 2 * cap * sizeof(*mst->incidentChild));
+    mst->incidentPriority = (unsigned*)realloc(mst->incidentPriority, 2 * cap * sizeof(unsigned));
+    mst->moved = (int*)realloc(mst->moved, cap * sizeof(int));
+    mst->demoted = (int*)realloc(mst->demoted, cap * sizeof(int));
+}
+
+DynamicMST* createDynamicMST(int V) {
+    DynamicMST* mst = (DynamicMST*)calloc(1, sizeof(DynamicMST));
+    mst->V = V;
+    mst->edgeCapacity = 4;
+    dynReserveEdges(mst);
+    for (int v = 0; v < V; v++)
+        lctInitNode(mst, v);
+    
+    // Trees of level i hold at most V / 2^i vertices, so edges stay below log2(V)
+    mst->levels = 1;
+    while ((2 << mst->levels) <= V)
+        mst->levels++;
+    int slots = V > 1 ? V - 1 : 1;
+    int tourNodes = mst->levels * (V + 2 * slots);
+    mst->tourChild = (int (*)[2])malloc(tourNodes * sizeof(*mst->tourChild));
+    mst->tourUp = (int*)malloc(tourNodes * sizeof(int));
+    mst->tourSize = (int*)malloc(tourNodes * sizeof(int));
+    mst->tourOwn = (int*)malloc(tourNodes * sizeof(int));
+    mst->tourBest = (int*)malloc(tourNodes * sizeof(int));
+    mst->tourMark = (unsigned char*)malloc(tourNodes);
+    for (int x = 0; x < mst->levels * V; x++)
+        tourInitNode(mst, x, 0);
+    mst->slotEdge = (int*)malloc(slots * sizeof(int));
+    mst->freeSlots = (int*)malloc(slots * sizeof(int));
+    for (int s = 0; s < slots; s++)
+        mst->freeSlots[mst->freeSlotCount++] = slots - 1 - s;
+    
+    mst->incidentRoot = (int*)malloc((mst->levels * V > 0 ? mst->levels * V : 1) * sizeof(int));
+    for (int x = 0; x < mst->levels * V; x++)
+        mst->incidentRoot[x] = -1;
+    mst->seed = 2463534242u;
+    mst->cutSide = (int*)malloc(mst->levels * sizeof(int));
+    mst->cutOpen = (unsigned char*)malloc(mst->levels);
+    return mst;
+}
+
+void freeDynamicMST(DynamicMST* mst) {
+    free(mst->edges);
+    free(mst->child);
+    free(mst->up);
+    free(mst->flip);
+    free(mst->heaviest);
+    free(mst->stack);
+    free(mst->tourChild);
+    free(mst->tourUp);
+    free(mst->tourSize);
+    free(mst->tourOwn);
+    free(mst->tourBest);
+    free(mst->tourMark);
+    free(mst->slotEdge);
+    free(mst->freeSlots);
+    free(mst->incidentRoot);
+    free(mst->incidentChild);
+    free(mst->incidentPriority);
+    free(mst->cutSide);
+    free(mst->cutOpen);
+    free(mst->moved);
+    free(mst->demoted);
+    free(mst);
+}
+
+// The endpoint of the cut edge whose level-i tree is the smaller half
+static int dynSmallerSide(DynamicMST* mst, int level, int u, int v) {
+    return tourTreeSize(mst, level, u) <= tourTreeSize(mst, level, v) ? u : v;
+}
+
+// Scan the level-i non-tree edges around side's tree lightest first. Edges
+// inside the tree are taken out into moved; the first one leaving it is
+// returned. Stops with -1 at bound or when none are left, and records in
+// cutOpen whether edges may remain that leave the tree.
+static int dynScanLevel(DynamicMST* mst, int level, int side, int bound) {
+    mst->cutOpen[level] = 1;
+    for (;;) {
+        int g = tourTreeBest(mst, level, side);
+        if (g == -1) {
+            mst->cutOpen[level] = 0;
+            return -1;
+        }
+        if (!dynLighter(mst, g, bound)) return -1;
+        if (!tourConnected(mst, level, mst->edges[g].u, mst->edges[g].v)) return g;
+        dynRemoveNonTree(mst, g);
+        mst->moved[mst->movedCount++] = g;
+    }
+}
+
+// Take every level-i non-tree edge around side's tree out of the level:
+// edges inside it go to moved, edges leaving it to demoted
+static void dynSweepLevel(DynamicMST* mst, int level, int side) {
+    int g;
+    while ((g = tourTreeBest(mst, level, side)) != -1) {
+        bool inside = tourConnected(mst, level, mst->edges[g].u, mst->edges[g].v);
+        dynRemoveNonTree(mst, g);
+        if (inside)
+            mst->moved[mst->movedCount++] = g;
+        else
+            mst->demoted[mst->demotedCount++] = g;
+    }
+}
+
+// Promote the tree edges of the searched half at levels top down to low,
+// then file the moved edges one level up if they came from those levels
+// and back at their own level otherwise. Must run before the reconnecting
+// edge is linked, which would merge the halves of levels up to its own.
+static void dynPromoteHalves(DynamicMST* mst, int top, int low) {
+    for (int i = top; i >= low; i--) {
+        int t;
+        while ((t = tourFindMarked(mst, i, mst->cutSide[i])) != -1)
+            dynPromoteTreeEdge(mst, t);
+    }
+    for (int j = 0; j < mst->movedCount; j++) {
+        int g = mst->moved[j];
+        int level = mst->edges[g].level;
+        dynAddNonTree(mst, g, level >= low ? level + 1 : level);
+    }
+    mst->movedCount = 0;
+}
+
+// Replace tree edge old by the lighter non-tree edge id, which closes a
+// cycle through it. id joins at level 0, so every higher level loses the
+// crossing edges that relied on old.
+static void dynSwapTreeEdge(DynamicMST* mst, int old, int id) {
+    DynamicEdge* f = &mst->edges[old];
+    int u = f->u, v = f->v, top = f->level;
+    dynCutEdge(mst, old);
+    mst->movedCount = mst->demotedCount = 0;
+    for (int i = top; i >= 1; i--) {
+        mst->cutSide[i] = dynSmallerSide(mst, i, u, v);
+        dynSweepLevel(mst, i, mst->cutSide[i]);
+    }
+    dynPromoteHalves(mst, top, 1);
+    
+    mst->edges[id].level = 0;
+    dynLinkEdge(mst, id);
+    dynAddNonTree(mst, old, 0);
+    for (int j = 0; j < mst->demotedCount; j++)
+        dynAddNonTree(mst, mst->demoted[j], 0);
+}
+
+// Offer non-tree edge id, not filed under any level, to the tree: it enters
+// if it joins two trees or is lighter than the heaviest edge on the cycle
+// it closes, and is filed at its level otherwise
+static void dynOfferEdge(DynamicMST* mst, int id, MSTDelta* delta) {
+    DynamicEdge* e = &mst->edges[id];
+    if (e->u == e->v) return;
+    
+    if (lctFindRoot(mst, e->u) != lctFindRoot(mst, e->v)) {
+        e->level = 0;
+        dynLinkEdge(mst, id);
+        delta->added[delta->addedCount++] = dynEdgeAsGraphEdge(mst, id);
+        return;
+    }
+    
+    int heaviest = lctPathMax(mst, e->u, e->v);
+    if (dynHeavier(mst, heaviest, mst->V + id)) {
+        int old = heaviest - mst->V;
+        dynSwapTreeEdge(mst, old, id);
+        delta->removed[delta->removedCount++] = dynEdgeAsGraphEdge(mst, old);
+        delta->added[delta->addedCount++] = dynEdgeAsGraphEdge(mst, id);
+    } else {
+        dynAddNonTree(mst, id, e->level);
+    }
+}
+
+// Take tree edge id out of the tree and reconnect with the lightest
+// replacement, which may be id itself when it is still the best choice.
+// A removal is reported with treeWeight, the weight id had in the tree.
+static void dynReplaceTreeEdge(DynamicMST* mst, int id, bool stillAlive, int treeWeight, MSTDelta* delta) {
+    DynamicEdge* e = &mst->edges[id];
+    int u = e->u, v = e->v, top = e->level;
+    dynCutEdge(mst, id);
+    mst->movedCount = mst->demotedCount = 0;
+    
+    // Search every level from the top; a lower level only has to look at
+    // edges lighter than the best found so far
+    int best = stillAlive ? id : -1;
+    int bestLevel = stillAlive ? top : -1;
+    for (int i = top; i >= 0; i--) {
+        mst->cutSide[i] = dynSmallerSide(mst, i, u, v);
+        int found = dynScanLevel(mst, i, mst->cutSide[i], best);
+        if (found != -1) {
+            best = found;
+            bestLevel = i;
+        }
+    }
+    
+    // Levels above the winner stay split, so their crossing edges move down
+    for (int i = bestLevel + 1; i <= top; i++)
+        if (mst->cutOpen[i])
+            dynSweepLevel(mst, i, mst->cutSide[i]);
+    dynPromoteHalves(mst, top, bestLevel > 0 ? bestLevel : 0);
+    
+    if (best == id) {
+        dynLinkEdge(mst, id);
+        return;
+    }
+    
+    GraphEdge removed = dynEdgeAsGraphEdge(mst, id);
+    removed.weight = treeWeight;
+    delta->removed[delta->removedCount++] = removed;
+    if (best != -1) {
+        dynRemoveNonTree(mst, best);
+        dynLinkEdge(mst, best);
+        delta->added[delta->addedCount++] = dynEdgeAsGraphEdge(mst, best);
+        for (int j = 0; j < mst->demotedCount; j++)
+            dynAddNonTree(mst, mst->demoted[j], bestLevel);
+        if (stillAlive)
+            dynAddNonTree(mst, id, bestLevel);
+    }
+}
+
+// Insert edge (u, v) of weight w and return its id, or -1 if an endpoint
+// is not a vertex
+int dynInsertEdge(DynamicMST* mst, int u, int v, int weight, MSTDelta* delta) {
+    deltaInit(delta);
+    if (u < 0 || u >= mst->V || v < 0 || v >= mst->V)
+        return -1;
+    if (mst->edgeCount == mst->edgeCapacity) {
+        mst->edgeCapacity *= 2;
+        dynReserveEdges(mst);
+    }
+    
+    int id = mst->edgeCount++;
+    DynamicEdge e = {u, v, weight, 0, -1, true, false};
+    mst->edges[id] = e;
+    for (int side = 0; side < 2; side++) {
+        mst->seed ^= mst->seed << 13;
+        mst->seed ^= mst->seed >> 17;
+        mst->seed ^= mst->seed << 5;
+        mst->incidentPriority[2 * id + side] = mst->seed;
+    }
+    
+    dynOfferEdge(mst, id, delta);
+    return id;
+}
+
+// Delete edge id; an unknown or deleted id leaves the delta empty
+void dynDeleteEdge(DynamicMST* mst, int id, MSTDelta* delta) {
+    deltaInit(delta);
+    if (id < 0 || id >= mst->edgeCount) return;
+    DynamicEdge* e = &mst->edges[id];
+    if (!e->alive) return;
+    e->alive = false;
+    if (e->inTree)
+        dynReplaceTreeEdge(mst, id, false, e->weight, delta);
+    else
+        dynRemoveNonTree(mst, id);
+}
+
+// Change the weight of edge id; an unknown or deleted id leaves the delta empty
+void dynUpdateWeight(DynamicMST* mst, int id, int weight, MSTDelta* delta) {
+    deltaInit(delta);
+    if (id < 0 || id >= mst->edgeCount) return;
+    DynamicEdge* e = &mst->edges[id];
+    if (!e->alive) return;
+    int old = e->weight;
+    
+    if (e->inTree) {
+        // Refresh the path maxima that include this edge node
+        int node = mst->V + id;
+        lctAccess(mst, node);
+        e->weight = weight;
+        lctPull(mst, node);
+        // A heavier tree edge may now lose to a non-tree edge
+        if (weight > old)
+            dynReplaceTreeEdge(mst, id, true, old, delta);
+    } else {
+        // Refile under the new weight; a lighter edge may now beat a tree edge
+        dynRemoveNonTree(mst, id);
+        e->weight = weight;
+        if (weight < old)
+            dynOfferEdge(mst, id, delta);
+        else
+            dynAddNonTree(mst, id, e->level);
+    }
+}
+
+// Treat the last vertex of a graph file as the arriving one: build the MST
+// of the others with one batch insertion, then insert it incrementally
+int runGraphFile(const char* path) {
+    MappedGraph file;
+    if (!openGraphFile(path, &file) || file.V == 0) {
+        fprintf(stderr, "Could not read a graph from %s\n", path);
+        return 1;
+    }
+    const CSRGraph* graph = graphFileCSR(&file);
+    int newVertex = file.V - 1;
+    
+    // Edges touching newVertex are out of range for the first V - 1
+    // vertices, so the batch insertion skips them
+    IncrementalMST* mst = createIncrementalMST(0, NULL, 0);
+    MSTDelta delta;
+    insertVertices(mst, newVertex, file.edges, file.E, &delta);
+    long long before = 0;
+    for (int i = 0; i < delta.addedCount; i++)
+        before += delta.added[i].weight;
+    printf("MST of vertices 0-%d: %d edges, weight %lld\n", newVertex - 1, delta.addedCount, before);
+    freeMSTDelta(&delta);
+    
+    int degree = csrDegree(graph, newVertex);
+    GraphEdge* incident = (GraphEdge*)malloc((degree > 0 ? degree : 1) * sizeof(GraphEdge));
+    int k = 0;
+    CSR_FOR_EACH_ARC(graph, newVertex, a) {
+        incident[k].src = newVertex;
+        incident[k].dest = graph->target[a];
+        incident[k].weight = graph->weight[a];
+        k++;
+    }
+    
+    int toNode, weight;
+    if (findBestEdge(newVertex, graph, newVertex, &toNode, &weight))
+        printf("Lightest edge to the new vertex %d: (%d - %d) weight %d\n", newVertex, toNode, newVertex, weight);
+    else
+        printf("New vertex is not connected to any node in MST.\n");
+    
+    insertVertex(mst, incident, k, &delta);
+    long long after = before;
+    for (int i = 0; i < delta.addedCount; i++)
+        after += delta.added[i].weight;
+    for (int i = 0; i < delta.removedCount; i++)
+        after -= delta.removed[i].weight;
+    printf("Inserted vertex %d: %d edges added, %d removed, weight %lld\n",
+           newVertex, delta.addedCount, delta.removedCount, after);
+    freeMSTDelta(&delta);
+    
+    free(incident);
+    freeIncrementalMST(mst);
+    closeGraphFile(&file);
+    return 0;
+}
+
+#ifndef MST_LIBRARY_ONLY
+int main(int argc, char** argv) {
+    // Run on a graph file (binary or text) when one is given
+    if (argc > 1)
+        return runGraphFile(argv[1]);
+    
     // Example: MST with 3 vertices
     int mstSize = 3;
     int newVertex = 3;
-    Edge* adjList[10] = {NULL}; // Combined adjacency list for all vertices
     
-    // Existing MST edges
-    addEdge(adjList, 0, 1, 1);
-    addEdge(adjList, 1, 0, 1);
-    addEdge(adjList, 1, 2, 2);
-    addEdge(adjList, 2, 1, 2);
+    // Existing MST edges, with room for the edge that attaches the new vertex
+    GraphEdge mstEdges[3] = {
+        {0, 1, 1},
+        {1, 2, 2},
+    };
+    int mstEdgeCount = 2;
     
-    // Add edges for the new vertex
-    addEdge(adjList, newVertex, 0, 4); // edge from 3 to 0 with weight 4
-    addEdge(adjList, newVertex, 1, 3); // edge from 3 to 1 with weight 3
-    addEdge(adjList, newVertex, 2, 6); // edge from 3 to 2 with weight 6
+    // Existing MST edges followed by the edges of the new vertex
+    GraphEdge edges[] = {
+        {0, 1, 1},
+        {1, 2, 2},
+        {newVertex, 0, 4}, // edge from 3 to 0 with weight 4
+        {newVertex, 1, 3}, // edge from 3 to 1 with weight 3
+        {newVertex, 2, 6}, // edge from 3 to 2 with weight 6
+    };
+    CSRGraph* graph = buildCSRGraph(mstSize + 1, edges, sizeof(edges) / sizeof(edges[0]));
     
     // Find minimal edge to connect new vertex to MST
     int toNode, weight;
-    if (findBestEdge(mstSize, adjList, newVertex, &toNode, &weight)) {
+    if (findBestEdge(mstSize, graph, newVertex, &toNode, &weight)) {
         printf("Connecting new vertex %d to MST using edge (%d - %d) with weight %d\n", 
                newVertex, toNode, newVertex, weight);
         
-        // Add the edge in both directions to maintain undirected graph property
-        addEdge(adjList, toNode, newVertex, weight);
+        // Add the edge to the MST edge list
+        mstEdges[mstEdgeCount].src = toNode;
+        mstEdges[mstEdgeCount].dest = newVertex;
+        mstEdges[mstEdgeCount].weight = weight;
+        mstEdgeCount++;
         
         // Increment MST size as we've added a new vertex
         mstSize++;
         
         // Print updated MST
         printf("\nUpdated MST:\n");
-        for (int i = 0; i < mstSize; i++) {
-            printf("Vertex %d:", i);
-            Edge* curr = adjList[i];
-            while (curr != NULL) {
-                // Only print edges that are part of the MST
-                // For this simple example, we know the MST edges
-                if ((i == 0 && curr->to == 1) || 
-                    (i == 1 && curr->to == 0) || 
-                    (i == 1 && curr->to == 2) || 
-                    (i == 2 && curr->to == 1) ||
-                    (i == toNode && curr->to == newVertex) ||
-                    (i == newVertex && curr->to == toNode)) {
-                    printf(" -> (%d, %d)", curr->to, curr->weight);
-                }
-                curr = curr->next;
-            }
-            printf("\n");
-        }
+        CSRGraph* mst = buildCSRGraph(mstSize, mstEdges, mstEdgeCount);
+        printGraph(mst);
+        freeCSRGraph(mst);
     } else {
         printf("New vertex is not connected to any node in MST.\n");
     }
     
+    freeCSRGraph(graph);
+    
+    // Stream the same insertion, then one whose edges replace a tree edge,
+    // through the incremental updater
+    printf("\nIncremental updates:\n");
+    GraphEdge initialTree[] = {
+        {0, 1, 1},
+        {1, 2, 2},
+    };
+    IncrementalMST* mst = createIncrementalMST(3, initialTree, 2);
+    
+    GraphEdge arrivals[][3] = {
+        {{3, 0, 4}, {3, 1, 3}, {3, 2, 6}},
+        {{4, 0, 1}, {4, 2, 1}, {4, 3, 5}},
+    };
+    for (int i = 0; i < 2; i++) {
+        MSTDelta delta;
+        int vertex = insertVertex(mst, arrivals[i], 3, &delta);
+        printf("Inserted vertex %d:\n", vertex);
+        printDelta(&delta);
+        freeMSTDelta(&delta);
+    }
+    
+    // A block of arrivals at once: vertices 5 and 6, joined to each other
+    // and to the existing tree
+    GraphEdge batch[] = {
+        {5, 6, 1},
+        {5, 3, 2},
+        {6, 1, 7},
+        {6, 4, 2},
+    };
+    MSTDelta batchDelta;
+    int first = insertVertices(mst, 2, batch, 4, &batchDelta);
+    printf("Inserted vertices %d-%d as a batch:\n", first, mst->V - 1);
+    printDelta(&batchDelta);
+    freeMSTDelta(&batchDelta);
+    
+    GraphEdge* treeEdges = (GraphEdge*)malloc(mst->V * sizeof(GraphEdge));
+    int treeCount = getTreeEdges(mst, treeEdges);
+    CSRGraph* tree = buildCSRGraph(mst->V, treeEdges, treeCount);
+    printf("\nUpdated MST:\n");
+    printGraph(tree);
+    freeCSRGraph(tree);
+    free(treeEdges);
+    freeIncrementalMST(mst);
+    
+    // Fully dynamic updates: links come and go, costs change
+    printf("\nDynamic updates:\n");
+    DynamicMST* dyn = createDynamicMST(4);
+    MSTDelta delta;
+    int links[5];
+    GraphEdge network[] = {
+        {0, 1, 1},
+        {1, 2, 2},
+        {2, 3, 3},
+        {0, 3, 4},
+        {0, 2, 5},
+    };
+    for (int i = 0; i < 5; i++) {
+        links[i] = dynInsertEdge(dyn, network[i].src, network[i].dest, network[i].weight, &delta);
+        printf("Insert (%d - %d) weight %d:\n", network[i].src, network[i].dest, network[i].weight);
+        printDelta(&delta);
+        freeMSTDelta(&delta);
+    }
+    
+    printf("Delete (1 - 2):\n");
+    dynDeleteEdge(dyn, links[1], &delta);
+    printDelta(&delta);
+    freeMSTDelta(&delta);
+    
+    printf("Raise (0 - 3) to weight 6:\n");
+    dynUpdateWeight(dyn, links[3], 6, &delta);
+    printDelta(&delta);
+    freeMSTDelta(&delta);
+    
+    printf("Lower (0 - 3) to weight 0:\n");
+    dynUpdateWeight(dyn, links[3], 0, &delta);
+    printDelta(&delta);
+    freeMSTDelta(&delta);
+    freeDynamicMST(dyn);
+    
     return 0;
 }
+#endif // MST_LIBRARY_ONLY
@@ -1,36 +1,29 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
+#include <limits.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
 
-// Graph representation
-typedef struct Edge {
-    int src;
-    int dest;
-    int weight;
-} Edge;
+#include "../common/csr_graph.h"
+#include "../common/indexed_heap.h"
+#include "../common/radix_sort.h"
+#include "../common/dsu.h"
+#include "../common/graph_file.h"
+#include "../common/mst_stats.h"
+#include "../common/parallel_ingest.h"
+#include "../common/external_sort.h"
 
+// Graph representation
 typedef struct Graph {
-    int V;          // Number of vertices
-    int E;          // Number of edges
-    Edge* edges;    // Array of edges
+    int V;              // Number of vertices
+    int E;              // Number of edges
+    GraphEdge* edges;   // Array of edges
 } Graph;
 
-// Adjacency list representation
-typedef struct AdjListNode {
-    int dest;
-    int weight;
-    struct AdjListNode* next;
-} AdjListNode;
-
-typedef struct AdjList {
-    AdjListNode* head;
-} AdjList;
-
-typedef struct AdjListGraph {
-    int V;
-    AdjList* array;
-} AdjListGraph;
-
 // Structure to store MST edge order
 typedef struct EdgeOrder {
     int src;
@@ -38,155 +31,433 @@ typedef struct EdgeOrder {
     int weight;
 } EdgeOrder;
 
+// Kruskal variants selectable from compareEdgeOrders
+typedef enum KruskalEngine {
+    KRUSKAL_SORT_ALL,   // Sort every edge up front
+    KRUSKAL_FILTER      // Filter-Kruskal: sort only the edges that can still matter
+} KruskalEngine;
+
 // Create a graph with V vertices and E edges
 Graph* createGraph(int V, int E) {
     Graph* graph = (Graph*)malloc(sizeof(Graph));
     graph->V = V;
     graph->E = E;
-    graph->edges = (Edge*)malloc(E * sizeof(Edge));
+    graph->edges = (GraphEdge*)malloc(E * sizeof(GraphEdge));
     return graph;
 }
 
-// Create an adjacency list graph
-AdjListGraph* createAdjListGraph(int V) {
-    AdjListGraph* graph = (AdjListGraph*)malloc(sizeof(AdjListGraph));
-    graph->V = V;
-    graph->array = (AdjList*)malloc(V * sizeof(AdjList));
+// Convert adjacency list to edge array, one edge per undirected pair.
+// Large graphs are split across threads that count and then fill their
+// own rows; the order is the same as a single row-by-row scan.
+Graph* adjListToEdgeArray(const CSRGraph* adjGraph) {
+    Graph* graph = (Graph*)malloc(sizeof(Graph));
+    graph->V = adjGraph->V;
+    graph->edges = csrToEdgeArray(adjGraph, &graph->E, 0);
+    return graph;
+}
+
+// Kruskal's algorithm to find MST
+EdgeOrder* kruskalMST(Graph* graph, int* mstSize) {
+    int V = graph->V;
+    EdgeOrder* result = (EdgeOrder*)malloc((V-1) * sizeof(EdgeOrder));
+    *mstSize = 0; // Number of edges in MST
+
+    // Step 1: Sort all edges in non-decreasing order of their weight
+    // (stable, so equal weights keep their edge-array order), in parallel
+    // on large graphs
+    STAT_TIMER_START(sortTimer);
+    parallelSortEdgesByWeight(graph->edges, graph->E, 0);
+    STAT_TIMER_STOP(sortTimer, "kruskal.sort");
+
+    // Create V subsets with single elements
+    STAT_TIMER_START(unionTimer);
+    DSU* sets = createDSU(V);
+    STAT_ADD(bytesAllocated, (V - 1) * sizeof(EdgeOrder));
+
+    // Number of edges to be taken is equal to V-1
+    int e = 0; // Index used for sorted edges
+    
+    // Process edges one by one
+    while (*mstSize < V - 1 && e < graph->E) {
+        // Step 2: Pick the smallest edge
+        GraphEdge next_edge = graph->edges[e++];
+        STAT_INC(edgesScanned);
+
+        // If including this edge doesn't cause cycle, include it in result
+        if (dsuUnion(sets, next_edge.src, next_edge.dest)) {
+            result[*mstSize].src = next_edge.src;
+            result[*mstSize].dest = next_edge.dest;
+            result[*mstSize].weight = next_edge.weight;
+            (*mstSize)++;
+        }
+    }
+
+    freeDSU(sets);
+    STAT_TIMER_STOP(unionTimer, "kruskal.union");
     
-    for (int i = 0; i < V; i++)
-        graph->array[i].head = NULL;
+    // If MST doesn't have V-1 edges, then graph is not connected
+    if (*mstSize != V - 1) {
+        printf("Graph is not connected. Kruskal's algorithm found %d edges for MST.\n", *mstSize);
+    }
     
-    return graph;
+    return result;
 }
 
-// Add an edge to the adjacency list graph
-void addEdge(AdjListGraph* graph, int src, int dest, int weight) {
-    // Add edge from src to dest
-    AdjListNode* newNode = (AdjListNode*)malloc(sizeof(AdjListNode));
-    newNode->dest = dest;
-    newNode->weight = weight;
-    newNode->next = graph->array[src].head;
-    graph->array[src].head = newNode;
-    
-    // Add edge from dest to src (undirected graph)
-    newNode = (AdjListNode*)malloc(sizeof(AdjListNode));
-    newNode->dest = src;
-    newNode->weight = weight;
-    newNode->next = graph->array[dest].head;
-    graph->array[dest].head = newNode;
+// Kruskal's algorithm for graph files too large for memory. The edges
+// stream out of an external sort in row order, which is the order
+// kruskalMST sees after adjListToEdgeArray and its stable sort, so both
+// pick the same edges in the same order. Only the DSU and the result stay
+// in memory. Returns NULL if the file cannot be read.
+EdgeOrder* externalKruskalMST(const char* path, const ExternalOptions* opts, int* mstSize, ExternalIOStats* io) {
+    ExternalOptions rowOpts = *opts;
+    rowOpts.rowOrder = true;
+    ExternalEdgeSort sorted;
+    *mstSize = 0;
+    if (!externalSortOpen(path, &rowOpts, &sorted)) {
+        *io = sorted.stats;
+        externalSortClose(&sorted);
+        return NULL;
+    }
+    
+    int V = sorted.V;
+    EdgeOrder* result = (EdgeOrder*)malloc((V > 1 ? V - 1 : 1) * sizeof(EdgeOrder));
+    DSU* sets = createDSU(V);
+    GraphEdge e;
+    while (*mstSize < V - 1 && externalSortNext(&sorted, &e)) {
+        STAT_INC(edgesScanned);
+        if (dsuUnion(sets, e.src, e.dest)) {
+            result[*mstSize].src = e.src;
+            result[*mstSize].dest = e.dest;
+            result[*mstSize].weight = e.weight;
+            (*mstSize)++;
+        }
+    }
+    freeDSU(sets);
+    
+    bool failed = externalSortFailed(&sorted);
+    *io = sorted.stats;
+    externalSortClose(&sorted);
+    if (failed) {
+        free(result);
+        return NULL;
+    }
+    if (*mstSize != V - 1) {
+        printf("Graph is not connected. Kruskal's algorithm found %d edges for MST.\n", *mstSize);
+    }
+    return result;
 }
 
-// Convert adjacency list to edge array
-Graph* adjListToEdgeArray(AdjListGraph* adjGraph) {
-    // Count edges first (we'll only count one direction since it's undirected)
-    int edgeCount = 0;
-    for (int i = 0; i < adjGraph->V; i++) {
-        AdjListNode* temp = adjGraph->array[i].head;
-        while (temp) {
-            if (i < temp->dest) { // Only count edges once
-                edgeCount++;
-            }
-            temp = temp->next;
+// Partitions at or below this size are sorted and scanned directly
+#ifndef FILTER_KRUSKAL_BASE
+#define FILTER_KRUSKAL_BASE 1024
+#endif
+
+// Sort key that orders edges by weight, then by position in the edge
+// array; this is exactly the order of the stable sort in kruskalMST
+static inline int64_t filterKruskalKey(const Graph* graph, int e) {
+    return (int64_t)graph->edges[e].weight * ((int64_t)1 << 32) + (uint32_t)e;
+}
+
+// Sorts the edge ids ids[0 .. n-1] by key and runs plain Kruskal on them
+void filterKruskalBase(const Graph* graph, const int* ids, int n, DSU* sets,
+                       EdgeOrder* result, int* mstSize) {
+    if (n <= 0)
+        return;
+    int64_t* keys = (int64_t*)malloc(n * sizeof(int64_t));
+    int* order = (int*)malloc(n * sizeof(int));
+    for (size_t i = 0; i < (size_t)n; i++)
+        keys[i] = filterKruskalKey(graph, ids[i]);
+    radixSortOrder64(keys, n, order);
+    
+    for (int i = 0; i < n && *mstSize < graph->V - 1; i++) {
+        GraphEdge next_edge = graph->edges[ids[order[i]]];
+        if (dsuUnion(sets, next_edge.src, next_edge.dest)) {
+            result[*mstSize].src = next_edge.src;
+            result[*mstSize].dest = next_edge.dest;
+            result[*mstSize].weight = next_edge.weight;
+            (*mstSize)++;
         }
     }
     
-    // Create edge array
-    Graph* graph = createGraph(adjGraph->V, edgeCount);
-    int edgeIndex = 0;
+    free(keys);
+    free(order);
+}
+
+// Heavy side of a partition, waiting until its light side is finished
+typedef struct FilterKruskalRange {
+    int start;
+    int n;
+} FilterKruskalRange;
+
+// Filter-Kruskal on the edge ids ids[0 .. n-1]. Partitions around a pivot
+// and descends into the light side, leaving the heavy side on a stack.
+// Once the light side is done, the heavy side is popped and its edges whose
+// endpoints are already connected are dropped before it is partitioned in
+// turn. The loop never recurses, so bad pivots cost time but not C stack.
+void filterKruskalRun(const Graph* graph, int* ids, int n, DSU* sets,
+                      EdgeOrder* result, int* mstSize) {
+    // Pending ranges are disjoint and non-empty, so n entries always suffice
+    FilterKruskalRange* pending = (FilterKruskalRange*)malloc((n > 0 ? n : 1) * sizeof(FilterKruskalRange));
+    int numPending = 0;
+    int start = 0;
     
-    for (int i = 0; i < adjGraph->V; i++) {
-        AdjListNode* temp = adjGraph->array[i].head;
-        while (temp) {
-            if (i < temp->dest) { // Only add edges once
-                graph->edges[edgeIndex].src = i;
-                graph->edges[edgeIndex].dest = temp->dest;
-                graph->edges[edgeIndex].weight = temp->weight;
-                edgeIndex++;
+    while (*mstSize < graph->V - 1) {
+        if (n == 0) {
+            if (numPending == 0)
+                break;
+            
+            // Keep only the heavy edges that still join two components
+            FilterKruskalRange next = pending[--numPending];
+            start = next.start;
+            n = 0;
+            for (int i = start; i < next.start + next.n; i++) {
+                GraphEdge* e = &graph->edges[ids[i]];
+                if (!dsuSame(sets, e->src, e->dest))
+                    ids[start + n++] = ids[i];
+            }
+            continue;
+        }
+        
+        if (n <= FILTER_KRUSKAL_BASE) {
+            // Small enough: sort by key and run plain Kruskal
+            filterKruskalBase(graph, ids + start, n, sets, result, mstSize);
+            n = 0;
+            continue;
+        }
+        
+        // Median of three keys; keys are distinct, so both halves are non-empty
+        int* part = ids + start;
+        int64_t a = filterKruskalKey(graph, part[0]);
+        int64_t b = filterKruskalKey(graph, part[n / 2]);
+        int64_t c = filterKruskalKey(graph, part[n - 1]);
+        int64_t pivot = a < b ? (b < c ? b : (a < c ? c : a)) : (a < c ? a : (b < c ? c : b));
+        
+        // Move the light edges (key <= pivot) to the front
+        int light = 0;
+        for (int i = 0; i < n; i++) {
+            if (filterKruskalKey(graph, part[i]) <= pivot) {
+                int tmp = part[light];
+                part[light] = part[i];
+                part[i] = tmp;
+                light++;
             }
-            temp = temp->next;
         }
+        
+        pending[numPending].start = start + light;
+        pending[numPending].n = n - light;
+        numPending++;
+        n = light;
     }
     
-    return graph;
+    free(pending);
 }
 
-// A utility function to find the subset of an element i
-int find(int parent[], int i) {
-    if (parent[i] != i)
-        parent[i] = find(parent, parent[i]);
-    return parent[i];
+// Filter-Kruskal to find MST. Produces the same edge order as kruskalMST
+// without sorting the heavy edges that can no longer join two trees, and
+// leaves the edge array untouched.
+EdgeOrder* filterKruskalMST(Graph* graph, int* mstSize) {
+    int V = graph->V;
+    EdgeOrder* result = (EdgeOrder*)malloc((V-1) * sizeof(EdgeOrder));
+    *mstSize = 0;
+    
+    DSU* sets = createDSU(V);
+    
+    int* ids = (int*)malloc(graph->E * sizeof(int));
+    for (int e = 0; e < graph->E; e++)
+        ids[e] = e;
+    
+    filterKruskalRun(graph, ids, graph->E, sets, result, mstSize);
+    
+    free(ids);
+    freeDSU(sets);
+    
+    if (*mstSize != V - 1) {
+        printf("Graph is not connected. Filter-Kruskal found %d edges for MST.\n", *mstSize);
+    }
+    
+    return result;
 }
 
-// A utility function to do union of two subsets
-void Union(int parent[], int rank[], int x, int y) {
-    int rootX = find(parent, x);
-    int rootY = find(parent, y);
+// No outgoing edge found for a component in the current Boruvka round
+#define BORUVKA_NO_EDGE UINT64_MAX
 
-    if (rootX == rootY) return;
+// Shared state of one parallel Boruvka run
+typedef struct BoruvkaState {
+    const Graph* graph;
+    _Atomic int* parent;        // Concurrent union-find forest
+    _Atomic uint64_t* best;     // Lightest outgoing edge key of each component root
+    int* chosen;                // Edge each root merged along this round, or -1
+    int numThreads;
+} BoruvkaState;
 
-    if (rank[rootX] < rank[rootY])
-        parent[rootX] = rootY;
-    else if (rank[rootX] > rank[rootY])
-        parent[rootY] = rootX;
-    else {
-        parent[rootY] = rootX;
-        rank[rootX]++;
-    }
-}
+// Per-thread slice of a parallel phase
+typedef struct BoruvkaTask {
+    BoruvkaState* state;
+    int begin;
+    int end;
+} BoruvkaTask;
 
-// Compare function for qsort to sort edges by weight
-int compareEdges(const void* a, const void* b) {
-    Edge* a1 = (Edge*)a;
-    Edge* b1 = (Edge*)b;
-    return a1->weight - b1->weight;
+// Order edges by (weight, index) as unsigned 64-bit keys, the same total
+// order Kruskal's stable sort uses, so all engines agree on ties
+static inline uint64_t boruvkaKey(const Graph* graph, int e) {
+    return ((uint64_t)((uint32_t)graph->edges[e].weight ^ 0x80000000u) << 32) | (uint32_t)e;
 }
 
-// Kruskal's algorithm to find MST
-EdgeOrder* kruskalMST(Graph* graph, int* mstSize) {
-    int V = graph->V;
-    EdgeOrder* result = (EdgeOrder*)malloc((V-1) * sizeof(EdgeOrder));
-    *mstSize = 0; // Number of edges in MST
+// Lock-free find with path halving
+static int concurrentFind(_Atomic int* parent, int x) {
+    for (;;) {
+        int p = atomic_load_explicit(&parent[x], memory_order_relaxed);
+        if (p == x)
+            return x;
+        int gp = atomic_load_explicit(&parent[p], memory_order_relaxed);
+        if (p == gp)
+            return p;
+        atomic_compare_exchange_weak(&parent[x], &p, gp);
+        x = gp;
+    }
+}
 
-    // Step 1: Sort all edges in non-decreasing order of their weight
-    qsort(graph->edges, graph->E, sizeof(Edge), compareEdges);
+// Lock-free union: the root with the larger id is linked below the other.
+// Returns false if x and y were already in the same set.
+static bool concurrentUnion(_Atomic int* parent, int x, int y) {
+    for (;;) {
+        x = concurrentFind(parent, x);
+        y = concurrentFind(parent, y);
+        if (x == y)
+            return false;
+        if (x < y) {
+            int tmp = x;
+            x = y;
+            y = tmp;
+        }
+        int expected = x;
+        if (atomic_compare_exchange_strong(&parent[x], &expected, y))
+            return true;
+    }
+}
 
-    // Allocate memory for creating V subsets
-    int* parent = (int*)malloc(V * sizeof(int));
-    int* rank = (int*)malloc(V * sizeof(int));
+// Phase 1: every edge that leaves its component offers itself to both
+// component roots, which keep the lightest offer
+static void* boruvkaFindLightest(void* arg) {
+    BoruvkaTask* task = (BoruvkaTask*)arg;
+    BoruvkaState* st = task->state;
+    
+    for (int e = task->begin; e < task->end; e++) {
+        int x = concurrentFind(st->parent, st->graph->edges[e].src);
+        int y = concurrentFind(st->parent, st->graph->edges[e].dest);
+        if (x == y) continue;
+        
+        uint64_t key = boruvkaKey(st->graph, e);
+        int roots[2] = {x, y};
+        for (int r = 0; r < 2; r++) {
+            uint64_t cur = atomic_load_explicit(&st->best[roots[r]], memory_order_relaxed);
+            while (key < cur &&
+                   !atomic_compare_exchange_weak(&st->best[roots[r]], &cur, key))
+                ;
+        }
+    }
+    return NULL;
+}
 
-    // Create V subsets with single elements
-    for (int v = 0; v < V; v++) {
-        parent[v] = v;
-        rank[v] = 0;
+// Phase 2: every component contracts along its lightest edge. When two
+// components picked the same edge only the first union succeeds.
+static void* boruvkaContract(void* arg) {
+    BoruvkaTask* task = (BoruvkaTask*)arg;
+    BoruvkaState* st = task->state;
+    
+    for (int v = task->begin; v < task->end; v++) {
+        st->chosen[v] = -1;
+        uint64_t key = atomic_load_explicit(&st->best[v], memory_order_relaxed);
+        if (key == BORUVKA_NO_EDGE) continue;
+        
+        int e = (int)(uint32_t)key;
+        if (concurrentUnion(st->parent, st->graph->edges[e].src, st->graph->edges[e].dest))
+            st->chosen[v] = e;
+        atomic_store_explicit(&st->best[v], BORUVKA_NO_EDGE, memory_order_relaxed);
     }
+    return NULL;
+}
 
-    // Number of edges to be taken is equal to V-1
-    int e = 0; // Index used for sorted edges
+// Split [0, n) evenly across the worker threads and run fn on each slice
+static void boruvkaRunParallel(BoruvkaState* st, int n, void* (*fn)(void*)) {
+    int T = st->numThreads;
+    pthread_t* threads = (pthread_t*)malloc(T * sizeof(pthread_t));
+    BoruvkaTask* tasks = (BoruvkaTask*)malloc(T * sizeof(BoruvkaTask));
     
-    // Process edges one by one
-    while (*mstSize < V - 1 && e < graph->E) {
-        // Step 2: Pick the smallest edge
-        Edge next_edge = graph->edges[e++];
+    for (int t = 0; t < T; t++) {
+        tasks[t].state = st;
+        tasks[t].begin = (int)((long long)n * t / T);
+        tasks[t].end = (int)((long long)n * (t + 1) / T);
+        pthread_create(&threads[t], NULL, fn, &tasks[t]);
+    }
+    for (int t = 0; t < T; t++)
+        pthread_join(threads[t], NULL);
+    
+    free(threads);
+    free(tasks);
+}
 
-        int x = find(parent, next_edge.src);
-        int y = find(parent, next_edge.dest);
+static double elapsedMs(const struct timespec* start, const struct timespec* end) {
+    return (end->tv_sec - start->tv_sec) * 1e3 + (end->tv_nsec - start->tv_nsec) / 1e6;
+}
 
-        // If including this edge doesn't cause cycle, include it in result
-        if (x != y) {
-            result[*mstSize].src = next_edge.src;
-            result[*mstSize].dest = next_edge.dest;
-            result[*mstSize].weight = next_edge.weight;
+// Parallel Boruvka's algorithm to find MST. Each round finds the lightest
+// outgoing edge of every component in parallel, then contracts along those
+// edges with a lock-free union-find. Ties break on edge index, so the edge
+// set matches kruskalMST. numThreads <= 0 uses every online CPU.
+EdgeOrder* boruvkaMST(Graph* graph, int* mstSize, int numThreads) {
+    int V = graph->V;
+    EdgeOrder* result = (EdgeOrder*)malloc((V-1) * sizeof(EdgeOrder));
+    *mstSize = 0;
+    
+    if (numThreads <= 0)
+        numThreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (numThreads < 1)
+        numThreads = 1;
+    
+    BoruvkaState st;
+    st.graph = graph;
+    st.numThreads = numThreads;
+    st.parent = (_Atomic int*)malloc(V * sizeof(_Atomic int));
+    st.best = (_Atomic uint64_t*)malloc(V * sizeof(_Atomic uint64_t));
+    st.chosen = (int*)malloc(V * sizeof(int));
+    for (int v = 0; v < V; v++) {
+        atomic_init(&st.parent[v], v);
+        atomic_init(&st.best[v], BORUVKA_NO_EDGE);
+    }
+    
+    for (int round = 1; *mstSize < V - 1; round++) {
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        
+        boruvkaRunParallel(&st, graph->E, boruvkaFindLightest);
+        boruvkaRunParallel(&st, V, boruvkaContract);
+        
+        // Collect the merged edges in root order so the output is deterministic
+        int added = 0;
+        for (int v = 0; v < V; v++) {
+            int e = st.chosen[v];
+            if (e == -1) continue;
+            result[*mstSize].src = graph->edges[e].src;
+            result[*mstSize].dest = graph->edges[e].dest;
+            result[*mstSize].weight = graph->edges[e].weight;
             (*mstSize)++;
-            Union(parent, rank, x, y);
+            added++;
         }
+        
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        if (added == 0)
+            break;
+        printf("Boruvka round %d: %d edges added, %.3f ms on %d threads\n",
+               round, added, elapsedMs(&start, &end), numThreads);
     }
-
-    free(parent);
-    free(rank);
     
-    // If MST doesn't have V-1 edges, then graph is not connected
+    free(st.parent);
+    free(st.best);
+    free(st.chosen);
+    
     if (*mstSize != V - 1) {
-        printf("Graph is not connected. Kruskal's algorithm found %d edges for MST.\n", *mstSize);
+        printf("Graph is not connected. Boruvka's algorithm found %d edges for MST.\n", *mstSize);
     }
     
     return result;
@@ -194,7 +465,7 @@ EdgeOrder* kruskalMST(Graph* graph, int* mstSize) {
 
 // Utility function to find the vertex with minimum key value
 int minKey(int key[], bool mstSet[], int V) {
-    int min = INT_MAX, min_index;
+    int min = INT_MAX, min_index = -1;
     
     for (int v = 0; v < V; v++)
         if (mstSet[v] == false && key[v] < min)
@@ -203,8 +474,9 @@ int minKey(int key[], bool mstSet[], int V) {
     return min_index;
 }
 
-// Prim's algorithm to find MST
-EdgeOrder* primMST(AdjListGraph* graph, int* mstSize) {
+// Prim's algorithm with an O(V) minimum-key scan per step, O(V^2) overall.
+// Only worth it on dense graphs.
+EdgeOrder* primMSTDense(const CSRGraph* graph, int* mstSize) {
     int V = graph->V;
     EdgeOrder* result = (EdgeOrder*)malloc((V-1) * sizeof(EdgeOrder));
     *mstSize = 0;
@@ -215,6 +487,7 @@ EdgeOrder* primMST(AdjListGraph* graph, int* mstSize) {
     int* key = (int*)malloc(V * sizeof(int));
     // To represent set of vertices included in MST
     bool* mstSet = (bool*)malloc(V * sizeof(bool));
+    STAT_ADD(bytesAllocated, (V - 1) * sizeof(EdgeOrder) + V * (2 * sizeof(int) + sizeof(bool)));
     
     // Initialize all keys as INFINITE
     for (int i = 0; i < V; i++) {
@@ -227,12 +500,12 @@ EdgeOrder* primMST(AdjListGraph* graph, int* mstSize) {
     parent[0] = -1; // First node is always root of MST
     
     // The MST will have V vertices
-    for (int count = 0; count < V - 1; count++) {
+    for (int count = 0; count < V; count++) {
         // Pick the minimum key vertex from the set of vertices not yet included in MST
         int u = minKey(key, mstSet, V);
         
         // If no vertex is reachable, break
-        if (key[u] == INT_MAX) {
+        if (u == -1) {
             printf("Graph is not connected. Prim's algorithm found %d edges for MST.\n", *mstSize);
             break;
         }
@@ -244,30 +517,20 @@ EdgeOrder* primMST(AdjListGraph* graph, int* mstSize) {
         if (parent[u] != -1) {
             result[*mstSize].src = parent[u];
             result[*mstSize].dest = u;
-            
-            // Find the weight of this edge
-            AdjListNode* temp = graph->array[parent[u]].head;
-            while (temp) {
-                if (temp->dest == u) {
-                    result[*mstSize].weight = temp->weight;
-                    break;
-                }
-                temp = temp->next;
-            }
-            
+            result[*mstSize].weight = key[u]; // key[u] is the weight of the parent edge
             (*mstSize)++;
         }
         
         // Update key value and parent index of the adjacent vertices of the picked vertex
-        AdjListNode* temp = graph->array[u].head;
-        while (temp) {
-            int v = temp->dest;
+        CSR_FOR_EACH_ARC(graph, u, a) {
+            int v = graph->target[a];
+            STAT_INC(edgesScanned);
             // If v is not yet included in MST and weight of u-v is less than key[v]
-            if (mstSet[v] == false && temp->weight < key[v]) {
+            if (mstSet[v] == false && graph->weight[a] < key[v]) {
+                STAT_INC(keyUpdates);
                 parent[v] = u;
-                key[v] = temp->weight;
+                key[v] = graph->weight[a];
             }
-            temp = temp->next;
         }
     }
     
@@ -278,114 +541,359 @@ EdgeOrder* primMST(AdjListGraph* graph, int* mstSize) {
     return result;
 }
 
-// Compare edge orders of Prim's and Kruskal's algorithms
-void compareEdgeOrders(AdjListGraph* adjGraph) {
-    // Convert adjacency list to edge array for Kruskal's algorithm
-    Graph* edgeGraph = adjListToEdgeArray(adjGraph);
+// Prim's algorithm driven by an indexed d-ary heap with decrease-key,
+// O(E log V). Picks the same vertex as primMSTDense at every step.
+EdgeOrder* primMSTHeap(const CSRGraph* graph, int* mstSize) {
+    int V = graph->V;
+    EdgeOrder* result = (EdgeOrder*)malloc((V-1) * sizeof(EdgeOrder));
+    *mstSize = 0;
     
-    int primMstSize, kruskalMstSize;
+    // Parent of each vertex in the MST and the weight of the edge to it
+    int* parent = (int*)malloc(V * sizeof(int));
+    int* parentWeight = (int*)malloc(V * sizeof(int));
+    // To represent set of vertices included in MST
+    bool* mstSet = (bool*)calloc(V, sizeof(bool));
+    IndexedHeap* heap = createIndexedHeap(V);
+    STAT_ADD(bytesAllocated, (V - 1) * sizeof(EdgeOrder) + V * (5 * sizeof(int) + sizeof(bool)));
     
-    // Get edge orders from both algorithms
-    EdgeOrder* primOrder = primMST(adjGraph, &primMstSize);
-    EdgeOrder* kruskalOrder = kruskalMST(edgeGraph, &kruskalMstSize);
+    // Always include first vertex in MST
+    parent[0] = -1;
+    heapPushOrDecrease(heap, 0, 0);
     
-    // Print the edge orders
-    printf("\nPrim's Algorithm Edge Order:\n");
-    printf("Order\tEdge\t\tWeight\n");
-    for (int i = 0; i < primMstSize; i++) {
-        printf("%d\t(%d-%d)\t\t%d\n", i+1, primOrder[i].src, primOrder[i].dest, primOrder[i].weight);
+    while (!heapIsEmpty(heap)) {
+        // Pick the queued vertex with the lightest connecting edge
+        int u = heapPopMin(heap);
+        mstSet[u] = true;
+        
+        // Add this edge to the result except for the first vertex
+        if (parent[u] != -1) {
+            result[*mstSize].src = parent[u];
+            result[*mstSize].dest = u;
+            result[*mstSize].weight = parentWeight[u];
+            (*mstSize)++;
+        }
+        
+        // Lower the key of every neighbour reached more cheaply through u
+        CSR_FOR_EACH_ARC(graph, u, a) {
+            int v = graph->target[a];
+            STAT_INC(edgesScanned);
+            if (!mstSet[v] && heapPushOrDecrease(heap, v, graph->weight[a])) {
+                STAT_INC(keyUpdates);
+                parent[v] = u;
+                parentWeight[v] = graph->weight[a];
+            }
+        }
     }
     
-    printf("\nKruskal's Algorithm Edge Order:\n");
+    if (*mstSize != V - 1) {
+        printf("Graph is not connected. Prim's algorithm found %d edges for MST.\n", *mstSize);
+    }
+    
+    free(parent);
+    free(parentWeight);
+    free(mstSet);
+    freeIndexedHeap(heap);
+    
+    return result;
+}
+
+// Prim's algorithm to find MST: the heap version for sparse graphs,
+// the array version once the graph is dense
+EdgeOrder* primMST(const CSRGraph* graph, int* mstSize) {
+    STAT_TIMER_START(timer);
+    EdgeOrder* result = csrIsDense(graph)
+        ? primMSTDense(graph, mstSize)
+        : primMSTHeap(graph, mstSize);
+    STAT_TIMER_STOP(timer, "prim");
+    return result;
+}
+
+// Print an MST edge order as a table
+void printEdgeOrder(const char* title, const EdgeOrder* order, int size) {
+    printf("\n%s Edge Order:\n", title);
     printf("Order\tEdge\t\tWeight\n");
-    for (int i = 0; i < kruskalMstSize; i++) {
-        printf("%d\t(%d-%d)\t\t%d\n", i+1, kruskalOrder[i].src, kruskalOrder[i].dest, kruskalOrder[i].weight);
+    for (int i = 0; i < size; i++) {
+        printf("%d\t(%d-%d)\t\t%d\n", i+1, order[i].src, order[i].dest, order[i].weight);
+    }
+}
+
+// Difference between two spanning forests of the same graph, from any
+// pair of engines
+typedef struct TreeDiff {
+    int common;             // Edges in both trees
+    int onlyACount;
+    int onlyBCount;
+    EdgeOrder* onlyA;       // Edges of a missing from b, in a's order
+    EdgeOrder* onlyB;       // Edges of b missing from a, in b's order
+    long long weightDelta;  // Total weight of b minus total weight of a
+    int firstDivergence;    // First position (0-based) where the orders differ, -1 if identical
+} TreeDiff;
+
+static bool sameEdge(const EdgeOrder* x, const EdgeOrder* y) {
+    return x->weight == y->weight &&
+           ((x->src == y->src && x->dest == y->dest) || (x->src == y->dest && x->dest == y->src));
+}
+
+// Diff two spanning forests over V vertices in O(V). Tree a is rooted in
+// every component by a BFS over its CSR, which gives each non-root vertex
+// a single parent edge; an edge (u, v) of b is shared exactly when it is
+// the parent edge of u or of v, with the same weight.
+TreeDiff diffSpanningTrees(int V, const EdgeOrder* a, int aSize, const EdgeOrder* b, int bSize) {
+    TreeDiff diff;
+    memset(&diff, 0, sizeof(diff));
+
+    GraphEdge* aEdges = (GraphEdge*)malloc((aSize > 0 ? aSize : 1) * sizeof(GraphEdge));
+    for (int i = 0; i < aSize; i++) {
+        aEdges[i].src = a[i].src;
+        aEdges[i].dest = a[i].dest;
+        aEdges[i].weight = a[i].weight;
+    }
+    CSRGraph* aTree = buildCSRGraph(V, aEdges, aSize);
+    free(aEdges);
+
+    // parentEdge[v]: index in a of the edge from v to its parent, -1 at roots
+    int* parent = (int*)malloc((V > 0 ? V : 1) * sizeof(int));
+    int* parentEdge = (int*)malloc((V > 0 ? V : 1) * sizeof(int));
+    int* queue = (int*)malloc((V > 0 ? V : 1) * sizeof(int));
+    bool* matched = (bool*)calloc(aSize > 0 ? aSize : 1, sizeof(bool));
+    for (int v = 0; v < V; v++)
+        parent[v] = -2;
+    for (int root = 0; root < V; root++) {
+        if (parent[root] != -2) continue;
+        int head = 0, tail = 0;
+        parent[root] = -1;
+        parentEdge[root] = -1;
+        queue[tail++] = root;
+        while (head < tail) {
+            int u = queue[head++];
+            CSR_FOR_EACH_ARC(aTree, u, arc) {
+                int v = aTree->target[arc];
+                if (parent[v] != -2) continue;
+                parent[v] = u;
+                parentEdge[v] = aTree->edgeId[arc];
+                queue[tail++] = v;
+            }
+        }
+    }
+    freeCSRGraph(aTree);
+
+    diff.onlyB = (EdgeOrder*)malloc((bSize > 0 ? bSize : 1) * sizeof(EdgeOrder));
+    for (int i = 0; i < bSize; i++) {
+        int u = b[i].src, v = b[i].dest, e = -1;
+        if (parent[u] == v && a[parentEdge[u]].weight == b[i].weight)
+            e = parentEdge[u];
+        else if (parent[v] == u && a[parentEdge[v]].weight == b[i].weight)
+            e = parentEdge[v];
+        if (e >= 0 && !matched[e]) {
+            matched[e] = true;
+            diff.common++;
+        } else {
+            diff.onlyB[diff.onlyBCount++] = b[i];
+        }
+        diff.weightDelta += b[i].weight;
+    }
+    diff.onlyA = (EdgeOrder*)malloc((aSize > 0 ? aSize : 1) * sizeof(EdgeOrder));
+    for (int i = 0; i < aSize; i++) {
+        if (!matched[i])
+            diff.onlyA[diff.onlyACount++] = a[i];
+        diff.weightDelta -= a[i].weight;
+    }
+
+    diff.firstDivergence = -1;
+    int shorter = aSize < bSize ? aSize : bSize;
+    for (int i = 0; i < shorter && diff.firstDivergence < 0; i++)
+        if (!sameEdge(&a[i], &b[i]))
+            diff.firstDivergence = i;
+    if (diff.firstDivergence < 0 && aSize != bSize)
+        diff.firstDivergence = shorter;
+
+    free(parent);
+    free(parentEdge);
+    free(queue);
+    free(matched);
+    return diff;
+}
+
+void freeTreeDiff(TreeDiff* diff) {
+    free(diff->onlyA);
+    free(diff->onlyB);
+    diff->onlyA = diff->onlyB = NULL;
+}
+
+// Print the parts of a diff beyond the common-edge count, listing at most
+// a few of the unique edges
+void printTreeDiff(const char* nameA, const char* nameB, const TreeDiff* diff) {
+    const int shown = 5;
+    if (diff->onlyACount > 0) {
+        printf("Only in %s: %d edges:", nameA, diff->onlyACount);
+        for (int i = 0; i < diff->onlyACount && i < shown; i++)
+            printf(" (%d-%d, %d)", diff->onlyA[i].src, diff->onlyA[i].dest, diff->onlyA[i].weight);
+        printf("%s\n", diff->onlyACount > shown ? " ..." : "");
     }
+    if (diff->onlyBCount > 0) {
+        printf("Only in %s: %d edges:", nameB, diff->onlyBCount);
+        for (int i = 0; i < diff->onlyBCount && i < shown; i++)
+            printf(" (%d-%d, %d)", diff->onlyB[i].src, diff->onlyB[i].dest, diff->onlyB[i].weight);
+        printf("%s\n", diff->onlyBCount > shown ? " ..." : "");
+    }
+    printf("Total weight of %s minus %s: %lld\n", nameB, nameA, diff->weightDelta);
+    if (diff->firstDivergence < 0)
+        printf("%s and %s added the edges in the same order.\n", nameA, nameB);
+    else
+        printf("%s and %s orders first differ at position %d.\n", nameA, nameB, diff->firstDivergence + 1);
+}
+
+// Compare edge orders of Prim's, Kruskal's and Boruvka's algorithms,
+// running the selected Kruskal engine
+void compareEdgeOrders(const CSRGraph* adjGraph, KruskalEngine engine) {
+    // Convert adjacency list to edge array for Kruskal's algorithm
+    Graph* edgeGraph = adjListToEdgeArray(adjGraph);
+    
+    int primMstSize, kruskalMstSize, boruvkaMstSize;
+    
+    // Get edge orders from all three algorithms; Boruvka runs first since
+    // kruskalMST sorts the edge array in place
+    EdgeOrder* primOrder = primMST(adjGraph, &primMstSize);
+    EdgeOrder* boruvkaOrder = boruvkaMST(edgeGraph, &boruvkaMstSize, 0);
+    EdgeOrder* kruskalOrder = engine == KRUSKAL_FILTER
+        ? filterKruskalMST(edgeGraph, &kruskalMstSize)
+        : kruskalMST(edgeGraph, &kruskalMstSize);
+    
+    // Print the edge orders
+    printEdgeOrder("Prim's Algorithm", primOrder, primMstSize);
+    printEdgeOrder(engine == KRUSKAL_FILTER ? "Filter-Kruskal" : "Kruskal's Algorithm",
+                   kruskalOrder, kruskalMstSize);
+    printEdgeOrder("Boruvka's Algorithm", boruvkaOrder, boruvkaMstSize);
     
     // Compare the two orders
+    TreeDiff diff = diffSpanningTrees(adjGraph->V, primOrder, primMstSize, kruskalOrder, kruskalMstSize);
     if (primMstSize != kruskalMstSize) {
         printf("\nThe two algorithms found different MSTs (different number of edges).\n");
     } else {
         printf("\nComparison of Edge Orders:\n");
+        printf("Edges in common: %d out of %d\n", diff.common, primMstSize);
         
-        // Sort both edge sets by weight for clearer comparison
-        int sameEdges = 0;
-        for (int i = 0; i < primMstSize; i++) {
-            bool found = false;
-            for (int j = 0; j < kruskalMstSize; j++) {
-                if ((primOrder[i].src == kruskalOrder[j].src && primOrder[i].dest == kruskalOrder[j].dest) ||
-                    (primOrder[i].src == kruskalOrder[j].dest && primOrder[i].dest == kruskalOrder[j].src)) {
-                    found = true;
-                    break;
-                }
-            }
-            if (found) sameEdges++;
-        }
-        
-        printf("Edges in common: %d out of %d\n", sameEdges, primMstSize);
-        
-        if (sameEdges == primMstSize) {
+        if (diff.common == primMstSize) {
             printf("Both algorithms found the same set of edges, but possibly in different orders.\n");
         } else {
             printf("The algorithms found different sets of edges for the MST.\n");
         }
     }
+    printTreeDiff("Prim", "Kruskal", &diff);
+    freeTreeDiff(&diff);
+    
+    // Boruvka breaks ties like Kruskal, so its edge set must match exactly
+    diff = diffSpanningTrees(adjGraph->V, boruvkaOrder, boruvkaMstSize, kruskalOrder, kruskalMstSize);
+    if (boruvkaMstSize == kruskalMstSize && diff.common == kruskalMstSize) {
+        printf("Boruvka's algorithm found the same edge set as Kruskal's.\n");
+    } else {
+        printf("Boruvka's algorithm differs from Kruskal's: %d of %d edges in common.\n",
+               diff.common, boruvkaMstSize);
+        printTreeDiff("Boruvka", "Kruskal", &diff);
+    }
+    freeTreeDiff(&diff);
     
     // Clean up
     free(primOrder);
     free(kruskalOrder);
+    free(boruvkaOrder);
     free(edgeGraph->edges);
     free(edgeGraph);
 }
 
-int main() {
+#ifndef MST_LIBRARY_ONLY
+int main(int argc, char** argv) {
+    // --stats dumps the operation counters as JSON on stderr at exit
+    bool stats = mstStatsTakeFlag(&argc, argv);
+    
+    // --external [--memory-mb n] [--temp-dir dir] runs Kruskal alone on a
+    // graph file, sorting the edges on disk within the memory budget
+    ExternalOptions external;
+    if (externalTakeOptions(&argc, argv, &external)) {
+        if (argc < 2 || external.invalid) {
+            fprintf(stderr, "Usage: %s --external [--memory-mb n] [--temp-dir dir] <graph>\n", argv[0]);
+            return 2;
+        }
+        int mstSize;
+        ExternalIOStats io;
+        EdgeOrder* order = externalKruskalMST(argv[1], &external, &mstSize, &io);
+        if (!order) {
+            fprintf(stderr, "Could not sort the edges of %s\n", argv[1]);
+            return 1;
+        }
+        printEdgeOrder("External Kruskal", order, mstSize);
+        externalPrintIOStats(stdout, &io);
+        free(order);
+        if (stats)
+            mstStatsPrintJSON(stderr);
+        return 0;
+    }
+    
+    // Compare the engines on a graph file (binary or text) when one is
+    // given; "filter" as a second argument selects Filter-Kruskal
+    if (argc > 1) {
+        MappedGraph file;
+        if (!openGraphFile(argv[1], &file)) {
+            fprintf(stderr, "Could not read a graph from %s\n", argv[1]);
+            return 1;
+        }
+        KruskalEngine engine = argc > 2 && strcmp(argv[2], "filter") == 0 ? KRUSKAL_FILTER : KRUSKAL_SORT_ALL;
+        compareEdgeOrders(graphFileCSR(&file), engine);
+        closeGraphFile(&file);
+        if (stats)
+            mstStatsPrintJSON(stderr);
+        return 0;
+    }
+    
     // Create a sample graph for testing
     int V = 5; // Number of vertices
-    AdjListGraph* graph = createAdjListGraph(V);
-    
-    // Add edges to the graph
-    addEdge(graph, 0, 1, 2);
-    addEdge(graph, 0, 3, 6);
-    addEdge(graph, 1, 2, 3);
-    addEdge(graph, 1, 3, 8);
-    addEdge(graph, 1, 4, 5);
-    addEdge(graph, 2, 4, 7);
-    addEdge(graph, 3, 4, 9);
+    GraphEdge edges[] = {
+        {0, 1, 2},
+        {0, 3, 6},
+        {1, 2, 3},
+        {1, 3, 8},
+        {1, 4, 5},
+        {2, 4, 7},
+        {3, 4, 9},
+    };
+    CSRGraph* graph = buildCSRGraph(V, edges, sizeof(edges) / sizeof(edges[0]));
     
     printf("Comparing edge orders of Prim's and Kruskal's algorithms:\n");
-    compareEdgeOrders(graph);
+    compareEdgeOrders(graph, KRUSKAL_SORT_ALL);
+    
+    printf("\n\nSame graph with Filter-Kruskal:\n");
+    compareEdgeOrders(graph, KRUSKAL_FILTER);
     
     // Example with a disconnected graph
     printf("\n\nTesting with a disconnected graph:\n");
-    AdjListGraph* disconnectedGraph = createAdjListGraph(5);
-    addEdge(disconnectedGraph, 0, 1, 1);
-    addEdge(disconnectedGraph, 2, 3, 2);
+    GraphEdge disconnectedEdges[] = {
+        {0, 1, 1},
+        {2, 3, 2},
+    };
     // Vertices 0,1 and 2,3 form disconnected components
-    compareEdgeOrders(disconnectedGraph);
+    CSRGraph* disconnectedGraph = buildCSRGraph(5, disconnectedEdges, 2);
+    compareEdgeOrders(disconnectedGraph, KRUSKAL_SORT_ALL);
     
     // Example with a complete graph
     printf("\n\nTesting with a complete graph:\n");
-    AdjListGraph* completeGraph = createAdjListGraph(4);
-    addEdge(completeGraph, 0, 1, 10);
-    addEdge(completeGraph, 0, 2, 6);
-    addEdge(completeGraph, 0, 3, 5);
-    addEdge(completeGraph, 1, 2, 15);
-    addEdge(completeGraph, 1, 3, 4);
-    addEdge(completeGraph, 2, 3, 8);
-    compareEdgeOrders(completeGraph);
+    GraphEdge completeEdges[] = {
+        {0, 1, 10},
+        {0, 2, 6},
+        {0, 3, 5},
+        {1, 2, 15},
+        {1, 3, 4},
+        {2, 3, 8},
+    };
+    CSRGraph* completeGraph = buildCSRGraph(4, completeEdges, 6);
+    compareEdgeOrders(completeGraph, KRUSKAL_SORT_ALL);
     
     // Clean up memory
-    // Free adjacency list
-    for (int i = 0; i < V; i++) {
-        AdjListNode* temp = graph->array[i].head;
-        while (temp) {
-            AdjListNode* next = temp->next;
-            free(temp);
-            temp = next;
-        }
-    }
-    free(graph->array);
-    free(graph);
+    freeCSRGraph(graph);
+    freeCSRGraph(disconnectedGraph);
+    freeCSRGraph(completeGraph);
     
+    if (stats)
+        mstStatsPrintJSON(stderr);
     return 0;
 }
+#endif // MST_LIBRARY_ONLY
@@ -3,195 +3,79 @@
 #include <stdbool.h>
 #include <limits.h>
 
-// Define edge structure
-typedef struct Edge {
-    int src;
-    int dest;
-    int weight;
-    struct Edge* next;
-} Edge;
-
-// Define graph structure
-typedef struct Graph {
-    int V;              // Number of vertices
-    Edge** adjList;     // Adjacency list
-} Graph;
-
-// Function to create a new edge
-Edge* createEdge(int src, int dest, int weight) {
-    Edge* newEdge = (Edge*)malloc(sizeof(Edge));
-    newEdge->src = src;
-    newEdge->dest = dest;
-    newEdge->weight = weight;
-    newEdge->next = NULL;
-    return newEdge;
-}
-
-// Function to create a graph with V vertices
-Graph* createGraph(int V) {
-    Graph* graph = (Graph*)malloc(sizeof(Graph));
-    graph->V = V;
-    graph->adjList = (Edge**)malloc(V * sizeof(Edge*));
-    
-    // Initialize all adjacency lists as empty
-    for (int i = 0; i < V; i++) {
-        graph->adjList[i] = NULL;
-    }
-    
-    return graph;
-}
-
-// Function to add an edge to the graph
-void addEdge(Graph* graph, int src, int dest, int weight) {
-    // Add edge from src to dest
-    Edge* newEdge = createEdge(src, dest, weight);
-    newEdge->next = graph->adjList[src];
-    graph->adjList[src] = newEdge;
-    
-    // Add edge from dest to src for undirected graph
-    newEdge = createEdge(dest, src, weight);
-    newEdge->next = graph->adjList[dest];
-    graph->adjList[dest] = newEdge;
-}
-
-// Structure to represent a subset for union-find
-typedef struct Subset {
-    int parent;
-    int rank;
-} Subset;
-
-// Find function with path compression
-int find(Subset subsets[], int i) {
-    if (subsets[i].parent != i)
-        subsets[i].parent = find(subsets, subsets[i].parent);
-    return subsets[i].parent;
-}
-
-// Union function by rank
-void Union(Subset subsets[], int x, int y) {
-    int rootX = find(subsets, x);
-    int rootY = find(subsets, y);
-    
-    if (rootX == rootY) return;
-    
-    // Attach smaller rank tree under root of higher rank tree
-    if (subsets[rootX].rank < subsets[rootY].rank)
-        subsets[rootX].parent = rootY;
-    else if (subsets[rootX].rank > subsets[rootY].rank)
-        subsets[rootY].parent = rootX;
-    else {
-        // If ranks are same, make one as root and increment its rank
-        subsets[rootY].parent = rootX;
-        subsets[rootX].rank++;
-    }
-}
-
-// Structure to store edges for Kruskal's algorithm
-typedef struct EdgeForKruskal {
-    int src, dest, weight;
-} EdgeForKruskal;
-
-// Compare function for qsort
-int compareEdges(const void* a, const void* b) {
-    return ((EdgeForKruskal*)a)->weight - ((EdgeForKruskal*)b)->weight;
-}
+#include "../common/csr_graph.h"
+#include "../common/indexed_heap.h"
+#include "../common/radix_sort.h"
+#include "../common/dsu.h"
+#include "../common/graph_file.h"
+#include "../common/mst_stats.h"
+#include "../common/parallel_ingest.h"
 
 // Method 1: Using Kruskal's algorithm
 // Check if the edge is in MST by removing it and seeing if MST weight increases
-bool isEdgeInMST_Kruskal(Graph* graph, int u, int v) {
+bool isEdgeInMST_Kruskal(const CSRGraph* graph, int u, int v) {
+    STAT_TIMER_START(timer);
     int V = graph->V;
-    int E = 0; // Count edges
+    int E;
     
-    // Count the total number of edges
-    for (int i = 0; i < V; i++) {
-        Edge* temp = graph->adjList[i];
-        while (temp) {
-            if (temp->src < temp->dest) // Count each edge only once
-                E++;
-            temp = temp->next;
-        }
-    }
-    
-    // Create an array of all edges
-    EdgeForKruskal* edges = (EdgeForKruskal*)malloc(E * sizeof(EdgeForKruskal));
-    int e = 0;
-    
-    for (int i = 0; i < V; i++) {
-        Edge* temp = graph->adjList[i];
-        while (temp) {
-            if (temp->src < temp->dest) { // Add each edge only once
-                edges[e].src = temp->src;
-                edges[e].dest = temp->dest;
-                edges[e].weight = temp->weight;
-                e++;
-            }
-            temp = temp->next;
-        }
-    }
+    // Collect each undirected edge once, in parallel on large graphs
+    GraphEdge* edges = csrToEdgeArray(graph, &E, 0);
+    STAT_ADD(bytesAllocated, E * sizeof(GraphEdge));
     
     // Sort edges in increasing order of weight
-    qsort(edges, E, sizeof(EdgeForKruskal), compareEdges);
-    
-    // Calculate MST weight with all edges
-    int mstWeight = 0;
-    Subset* subsets = (Subset*)malloc(V * sizeof(Subset));
-    
-    // Initialize subsets
-    for (int i = 0; i < V; i++) {
-        subsets[i].parent = i;
-        subsets[i].rank = 0;
+    parallelSortEdgesByWeight(edges, E, 0);
+    
+    // Both passes agree on every edge sorted before the first copy of
+    // (u, v), so run that prefix once
+    DSU* sets = createDSU(V);
+    int split = 0;
+    int prefixWeight = 0;
+    int prefixCount = 0;
+    for (; split < E && prefixCount < V - 1; split++) {
+        if ((edges[split].src == u && edges[split].dest == v) ||
+            (edges[split].src == v && edges[split].dest == u))
+            break;
+        STAT_INC(edgesScanned);
+        if (dsuUnion(sets, edges[split].src, edges[split].dest)) {
+            prefixWeight += edges[split].weight;
+            prefixCount++;
+        }
     }
     
-    int edgeCount = 0;
-    for (int i = 0; i < E && edgeCount < V - 1; i++) {
-        int setU = find(subsets, edges[i].src);
-        int setV = find(subsets, edges[i].dest);
-        
-        if (setU != setV) {
+    // Calculate MST weight with all edges, then undo back to the prefix
+    dsuCheckpoint(sets);
+    int mstWeight = prefixWeight;
+    int edgeCount = prefixCount;
+    for (int i = split; i < E && edgeCount < V - 1; i++) {
+        STAT_INC(edgesScanned);
+        if (dsuUnion(sets, edges[i].src, edges[i].dest)) {
             mstWeight += edges[i].weight;
-            Union(subsets, setU, setV);
             edgeCount++;
         }
     }
-    
-    // Reset subsets for recalculation
-    for (int i = 0; i < V; i++) {
-        subsets[i].parent = i;
-        subsets[i].rank = 0;
-    }
+    dsuRollback(sets);
     
     // Calculate MST weight without the specified edge
-    int mstWeightWithoutEdge = 0;
-    edgeCount = 0;
-    
-    for (int i = 0; i < E && edgeCount < V - 1; i++) {
+    int mstWeightWithoutEdge = prefixWeight;
+    edgeCount = prefixCount;
+    for (int i = split; i < E && edgeCount < V - 1; i++) {
         // Skip the specified edge
         if ((edges[i].src == u && edges[i].dest == v) || 
             (edges[i].src == v && edges[i].dest == u))
             continue;
-            
-        int setU = find(subsets, edges[i].src);
-        int setV = find(subsets, edges[i].dest);
-        
-        if (setU != setV) {
+        STAT_INC(edgesScanned);
+        if (dsuUnion(sets, edges[i].src, edges[i].dest)) {
             mstWeightWithoutEdge += edges[i].weight;
-            Union(subsets, setU, setV);
             edgeCount++;
         }
     }
     
     // Check if graph is still connected
-    bool isConnected = true;
-    int root = find(subsets, 0);
-    for (int i = 1; i < V; i++) {
-        if (find(subsets, i) != root) {
-            isConnected = false;
-            break;
-        }
-    }
+    bool isConnected = sets->sets == 1;
     
-    free(subsets);
+    freeDSU(sets);
     free(edges);
+    STAT_TIMER_STOP(timer, "isEdgeInMST_Kruskal");
     
     // If graph is not connected without the edge, it's a bridge and must be in MST
     if (!isConnected)
@@ -201,158 +85,166 @@ bool isEdgeInMST_Kruskal(Graph* graph, int u, int v) {
     return mstWeightWithoutEdge > mstWeight;
 }
 
-// Method 2: Using cycle property
-// An edge is in MST if and only if it's the minimum weight edge in a cycle it forms
-bool isEdgeInMST_CycleProperty(Graph* graph, int u, int v) {
-    // Find the weight of edge (u, v)
-    int edgeWeight = INT_MAX;
-    Edge* temp = graph->adjList[u];
-    while (temp) {
-        if (temp->dest == v) {
-            edgeWeight = temp->weight;
-            break;
-        }
-        temp = temp->next;
-    }
-    
-    if (edgeWeight == INT_MAX) {
-        printf("Edge (%d, %d) not found in the graph\n", u, v);
-        return false;
-    }
-    
-    // Create a subgraph by removing edge (u, v)
-    Graph* subgraph = createGraph(graph->V);
-    for (int i = 0; i < graph->V; i++) {
-        temp = graph->adjList[i];
-        while (temp) {
-            if (!((temp->src == u && temp->dest == v) || 
-                  (temp->src == v && temp->dest == u))) {
-                addEdge(subgraph, temp->src, temp->dest, temp->weight);
-            }
-            temp = temp->next;
-        }
-    }
-    
-    // Check if there's a path from u to v in the subgraph
-    // If not, then (u, v) is a bridge and must be in the MST
+// True if u and v are joined by a path whose edges all weigh less than
+// limit. One BFS over the CSR arrays, O(V + E), no copy of the graph.
+bool lighterPathExists(const CSRGraph* graph, int u, int v, int limit) {
     bool* visited = (bool*)calloc(graph->V, sizeof(bool));
-    
-    // DFS to check if v is reachable from u
-    bool dfs(Graph* g, int start, int target, bool visited[]) {
-        visited[start] = true;
-        if (start == target)
-            return true;
-            
-        Edge* temp = g->adjList[start];
-        while (temp) {
-            if (!visited[temp->dest]) {
-                if (dfs(g, temp->dest, target, visited))
-                    return true;
+    int* queue = (int*)malloc(graph->V * sizeof(int));
+    STAT_ADD(bytesAllocated, graph->V * (sizeof(bool) + sizeof(int)));
+    int head = 0, tail = 0;
+    bool found = false;
+    
+    visited[u] = true;
+    queue[tail++] = u;
+    while (head < tail && !found) {
+        int x = queue[head++];
+        CSR_FOR_EACH_ARC(graph, x, a) {
+            int y = graph->target[a];
+            STAT_INC(edgesScanned);
+            if (graph->weight[a] >= limit || visited[y]) continue;
+            if (y == v) {
+                found = true;
+                break;
             }
-            temp = temp->next;
+            visited[y] = true;
+            queue[tail++] = y;
         }
-        return false;
     }
     
-    bool isReachable = dfs(subgraph, u, v, visited);
     free(visited);
+    free(queue);
+    return found;
+}
+
+// Method 2: Using cycle property
+// An edge is in some MST if and only if it is not the strictly heaviest edge
+// of any cycle, i.e. u and v are not connected by edges lighter than (u, v).
+// The edge itself is never lighter than its own weight, so it drops out of
+// the search without building a subgraph.
+bool isEdgeInMST_CycleProperty(const CSRGraph* graph, int u, int v) {
+    // A self-loop is never part of a spanning tree
+    if (u == v)
+        return false;
     
-    // If not reachable, edge is a bridge and must be in MST
-    if (!isReachable)
-        return true;
-    
-    // If reachable, then check if edge (u, v) is the minimum weight edge 
-    // in the cycle formed by the path from u to v plus the edge (u, v)
-    // This requires finding the path and checking all edge weights
-    
-    // For simplicity, we can use a different approach:
-    // Run a modified DFS to find the minimum weight edge in any path from u to v
-    
-    bool hasWeakEdge(Graph* g, int start, int target, bool visited[], int* minWeight) {
-        visited[start] = true;
-        if (start == target)
-            return true;
-            
-        Edge* temp = g->adjList[start];
-        while (temp) {
-            if (!visited[temp->dest]) {
-                if (hasWeakEdge(g, temp->dest, target, visited, minWeight)) {
-                    if (temp->weight < *minWeight)
-                        *minWeight = temp->weight;
-                    return true;
-                }
-            }
-            temp = temp->next;
+    // Find the weight of edge (u, v)
+    int edgeWeight = INT_MAX;
+    bool exists = false;
+    CSR_FOR_EACH_ARC(graph, u, a) {
+        if (graph->target[a] == v && (!exists || graph->weight[a] < edgeWeight)) {
+            edgeWeight = graph->weight[a];
+            exists = true;
         }
-        visited[start] = false; // Backtrack
-        return false;
     }
     
-    visited = (bool*)calloc(graph->V, sizeof(bool));
-    int minWeight = INT_MAX;
-    hasWeakEdge(subgraph, u, v, visited, &minWeight);
-    free(visited);
-    
-    // Free the subgraph
-    for (int i = 0; i < subgraph->V; i++) {
-        temp = subgraph->adjList[i];
-        while (temp) {
-            Edge* next = temp->next;
-            free(temp);
-            temp = next;
-        }
+    if (!exists) {
+        printf("Edge (%d, %d) not found in the graph\n", u, v);
+        return false;
     }
-    free(subgraph->adjList);
-    free(subgraph);
     
-    // If edge (u, v) has weight strictly less than the minimum weight edge
-    // in any path from u to v in the subgraph, then it must be in the MST
-    return edgeWeight < minWeight;
+    // A bridge, or an edge no lighter path can bypass, belongs to an MST
+    STAT_TIMER_START(timer);
+    bool inMST = !lighterPathExists(graph, u, v, edgeWeight);
+    STAT_TIMER_STOP(timer, "isEdgeInMST_CycleProperty");
+    return inMST;
 }
 
-// Method 3: Using Prim's algorithm
-// Run Prim's and check if the edge is selected
-bool isEdgeInMST_Prim(Graph* graph, int u, int v) {
+// Build Prim's tree with an O(V) minimum-key scan per step, O(V^2) overall.
+// parent[i] is -1 for the root and for vertices Prim never reached.
+void primTreeDense(const CSRGraph* graph, int* parent, int* parentWeight) {
     int V = graph->V;
-    int* parent = (int*)malloc(V * sizeof(int));
-    int* key = (int*)malloc(V * sizeof(int));
     bool* mstSet = (bool*)calloc(V, sizeof(bool));
     
     // Initialize all keys as INFINITE
     for (int i = 0; i < V; i++) {
-        key[i] = INT_MAX;
+        parentWeight[i] = INT_MAX;
         parent[i] = -1;
     }
     
     // Start with the first vertex
-    key[0] = 0;
+    parentWeight[0] = 0;
     
     // MST will have V vertices
     for (int count = 0; count < V - 1; count++) {
         // Pick the minimum key vertex not yet included in MST
-        int minKey = INT_MAX, minIndex;
+        int minKey = INT_MAX, minIndex = -1;
         for (int v = 0; v < V; v++) {
-            if (mstSet[v] == false && key[v] < minKey) {
-                minKey = key[v];
+            if (mstSet[v] == false && parentWeight[v] < minKey) {
+                minKey = parentWeight[v];
                 minIndex = v;
             }
         }
         
+        // Stop once the rest of the graph is unreachable
+        if (minIndex == -1)
+            break;
+        
         // Add the picked vertex to the MST set
         mstSet[minIndex] = true;
         
         // Update key values of the adjacent vertices
-        Edge* temp = graph->adjList[minIndex];
-        while (temp) {
-            int v = temp->dest;
-            if (mstSet[v] == false && temp->weight < key[v]) {
+        CSR_FOR_EACH_ARC(graph, minIndex, a) {
+            int v = graph->target[a];
+            STAT_INC(edgesScanned);
+            if (mstSet[v] == false && graph->weight[a] < parentWeight[v]) {
+                STAT_INC(keyUpdates);
                 parent[v] = minIndex;
-                key[v] = temp->weight;
+                parentWeight[v] = graph->weight[a];
             }
-            temp = temp->next;
         }
     }
     
+    free(mstSet);
+}
+
+// Build Prim's tree with an indexed d-ary heap, O(E log V). Selects the
+// same vertex as primTreeDense at every step.
+void primTreeHeap(const CSRGraph* graph, int* parent, int* parentWeight) {
+    int V = graph->V;
+    bool* mstSet = (bool*)calloc(V, sizeof(bool));
+    IndexedHeap* heap = createIndexedHeap(V);
+    
+    for (int i = 0; i < V; i++)
+        parent[i] = -1;
+    
+    // Start with the first vertex
+    parentWeight[0] = 0;
+    heapPushOrDecrease(heap, 0, 0);
+    
+    while (!heapIsEmpty(heap)) {
+        int u = heapPopMin(heap);
+        mstSet[u] = true;
+        
+        // Lower the key of every neighbour reached more cheaply through u
+        CSR_FOR_EACH_ARC(graph, u, a) {
+            int v = graph->target[a];
+            STAT_INC(edgesScanned);
+            if (!mstSet[v] && heapPushOrDecrease(heap, v, graph->weight[a])) {
+                STAT_INC(keyUpdates);
+                parent[v] = u;
+                parentWeight[v] = graph->weight[a];
+            }
+        }
+    }
+    
+    free(mstSet);
+    freeIndexedHeap(heap);
+}
+
+// Method 3: Using Prim's algorithm
+// Run Prim's and check if the edge is selected
+bool isEdgeInMST_Prim(const CSRGraph* graph, int u, int v) {
+    STAT_TIMER_START(timer);
+    int V = graph->V;
+    int* parent = (int*)malloc(V * sizeof(int));
+    int* parentWeight = (int*)malloc(V * sizeof(int));
+    STAT_ADD(bytesAllocated, V * (2 * sizeof(int) + sizeof(bool)));
+    
+    // The heap version for sparse graphs, the array version once the graph is dense
+    if (csrIsDense(graph))
+        primTreeDense(graph, parent, parentWeight);
+    else
+        primTreeHeap(graph, parent, parentWeight);
+    
     // Check if edge (u, v) is in the MST
     bool inMST = false;
     for (int i = 1; i < V; i++) {
@@ -363,24 +255,296 @@ bool isEdgeInMST_Prim(Graph* graph, int u, int v) {
     }
     
     free(parent);
-    free(key);
-    free(mstSet);
+    free(parentWeight);
+    STAT_TIMER_STOP(timer, "isEdgeInMST_Prim");
     
     return inMST;
 }
 
-int main() {
-    // Create a sample graph
-    Graph* graph = createGraph(5);
+// Method 4: Batch queries against a preprocessed MST
+// The MST is built once and rooted; binary-lifting tables give the maximum
+// edge weight on any tree path in O(log V), and every tree edge remembers
+// the lightest non-tree edge that could replace it.
+
+// Query for an edge (u, v) of weight w. It need not be in the graph: the
+// answer is then for the graph with the edge added.
+typedef struct EdgeQuery {
+    int u;
+    int v;
+    int weight;
+} EdgeQuery;
+
+// Answer to an EdgeQuery
+typedef struct EdgeMembership {
+    bool inSomeMST;     // The edge belongs to at least one MST
+    bool inEveryMST;    // The edge belongs to every MST
+} EdgeMembership;
+
+typedef struct MSTIndex {
+    int V;
+    int levels;         // Number of binary-lifting levels
+    int* depth;         // Depth of each vertex in its tree
+    int* component;     // Root of the tree containing each vertex
+    int* up;            // up[k * V + v]: 2^k-th ancestor of v (the root saturates)
+    int* upMax;         // upMax[k * V + v]: heaviest edge on those 2^k steps
+    int* replacement;   // Lightest non-tree edge covering edge (v, parent(v)), INT_MAX if none
+} MSTIndex;
+
+// Find with path compression over the "already covered" forest used while
+// assigning replacement weights; covered tree edges point to their parent
+static int findUncovered(int* jump, int v) {
+    int root = v;
+    while (jump[root] != root)
+        root = jump[root];
+    while (jump[v] != root) {
+        int next = jump[v];
+        jump[v] = root;
+        v = next;
+    }
+    return root;
+}
+
+// Build the MST of graph and preprocess it for path-maximum queries
+MSTIndex* buildMSTIndex(const CSRGraph* graph) {
+    STAT_TIMER_START(timer);
+    int V = graph->V;
+    
+    // Collect each undirected edge once and sort by weight
+    int E;
+    GraphEdge* edges = csrToEdgeArray(graph, &E, 0);
+    parallelSortEdgesByWeight(edges, E, 0);
+    
+    // Kruskal's algorithm, remembering which edges entered the tree
+    DSU* sets = createDSU(V);
+    bool* inTree = (bool*)calloc(E > 0 ? E : 1, sizeof(bool));
+    GraphEdge* treeEdges = (GraphEdge*)malloc((V > 0 ? V : 1) * sizeof(GraphEdge));
+    int treeSize = 0;
+    for (int i = 0; i < E && treeSize < V - 1; i++) {
+        if (dsuUnion(sets, edges[i].src, edges[i].dest)) {
+            inTree[i] = true;
+            treeEdges[treeSize++] = edges[i];
+        }
+    }
+    freeDSU(sets);
+    
+    MSTIndex* index = (MSTIndex*)malloc(sizeof(MSTIndex));
+    index->V = V;
+    index->levels = 1;
+    while ((1 << index->levels) < V)
+        index->levels++;
+    index->depth = (int*)malloc(V * sizeof(int));
+    index->component = (int*)malloc(V * sizeof(int));
+    index->up = (int*)malloc((size_t)index->levels * V * sizeof(int));
+    index->upMax = (int*)malloc((size_t)index->levels * V * sizeof(int));
+    index->replacement = (int*)malloc(V * sizeof(int));
+    
+    // Root every tree with a BFS; level 0 of the tables is the parent edge
+    CSRGraph* tree = buildCSRGraph(V, treeEdges, treeSize);
+    int* queue = (int*)malloc(V * sizeof(int));
+    for (int v = 0; v < V; v++)
+        index->component[v] = -1;
+    for (int r = 0; r < V; r++) {
+        if (index->component[r] != -1) continue;
+        int head = 0, tail = 0;
+        queue[tail++] = r;
+        index->component[r] = r;
+        index->depth[r] = 0;
+        index->up[r] = r;
+        index->upMax[r] = INT_MIN;
+        while (head < tail) {
+            int x = queue[head++];
+            CSR_FOR_EACH_ARC(tree, x, a) {
+                int y = tree->target[a];
+                if (index->component[y] != -1) continue;
+                index->component[y] = r;
+                index->depth[y] = index->depth[x] + 1;
+                index->up[y] = x;
+                index->upMax[y] = tree->weight[a];
+                queue[tail++] = y;
+            }
+        }
+    }
+    free(queue);
+    freeCSRGraph(tree);
+    free(treeEdges);
+    
+    for (int k = 1; k < index->levels; k++) {
+        int* prevUp = index->up + (size_t)(k - 1) * V;
+        int* prevMax = index->upMax + (size_t)(k - 1) * V;
+        int* curUp = index->up + (size_t)k * V;
+        int* curMax = index->upMax + (size_t)k * V;
+        for (int v = 0; v < V; v++) {
+            int mid = prevUp[v];
+            curUp[v] = prevUp[mid];
+            curMax[v] = prevMax[v] > prevMax[mid] ? prevMax[v] : prevMax[mid];
+        }
+    }
     
-    // Add edges to the graph
-    addEdge(graph, 0, 1, 2);
-    addEdge(graph, 0, 3, 6);
-    addEdge(graph, 1, 2, 3);
-    addEdge(graph, 1, 3, 8);
-    addEdge(graph, 1, 4, 5);
-    addEdge(graph, 2, 4, 7);
-    addEdge(graph, 3, 4, 9);
+    // Non-tree edges in increasing weight cover the uncovered tree edges on
+    // their path; the first edge to cover a tree edge is its replacement
+    int* jump = (int*)malloc(V * sizeof(int));
+    for (int v = 0; v < V; v++) {
+        jump[v] = v;
+        index->replacement[v] = INT_MAX;
+    }
+    for (int i = 0; i < E; i++) {
+        if (inTree[i]) continue;
+        int x = findUncovered(jump, edges[i].src);
+        int y = findUncovered(jump, edges[i].dest);
+        while (x != y) {
+            if (index->depth[x] < index->depth[y]) {
+                int tmp = x;
+                x = y;
+                y = tmp;
+            }
+            index->replacement[x] = edges[i].weight;
+            jump[x] = index->up[x];
+            x = findUncovered(jump, x);
+        }
+    }
+    free(jump);
+    free(inTree);
+    free(edges);
+    STAT_TIMER_STOP(timer, "buildMSTIndex");
+    
+    return index;
+}
+
+void freeMSTIndex(MSTIndex* index) {
+    free(index->depth);
+    free(index->component);
+    free(index->up);
+    free(index->upMax);
+    free(index->replacement);
+    free(index);
+}
+
+// Heaviest edge weight on the tree path between u and v, in O(log V)
+int pathMaxWeight(const MSTIndex* index, int u, int v) {
+    int V = index->V;
+    int best = INT_MIN;
+    if (index->depth[u] < index->depth[v]) {
+        int tmp = u;
+        u = v;
+        v = tmp;
+    }
+    
+    // Lift u to the depth of v
+    int diff = index->depth[u] - index->depth[v];
+    for (int k = 0; diff > 0; k++, diff >>= 1) {
+        if (diff & 1) {
+            if (index->upMax[(size_t)k * V + u] > best)
+                best = index->upMax[(size_t)k * V + u];
+            u = index->up[(size_t)k * V + u];
+        }
+    }
+    if (u == v)
+        return best;
+    
+    // Lift both until they sit just below the lowest common ancestor
+    for (int k = index->levels - 1; k >= 0; k--) {
+        size_t i = (size_t)k * V;
+        if (index->up[i + u] != index->up[i + v]) {
+            if (index->upMax[i + u] > best) best = index->upMax[i + u];
+            if (index->upMax[i + v] > best) best = index->upMax[i + v];
+            u = index->up[i + u];
+            v = index->up[i + v];
+        }
+    }
+    if (index->upMax[u] > best) best = index->upMax[u];
+    if (index->upMax[v] > best) best = index->upMax[v];
+    return best;
+}
+
+// Answer a batch of edge-membership queries, O(log V) each
+void queryEdgesInMST(const MSTIndex* index, const EdgeQuery* queries, int count, EdgeMembership* answers) {
+    STAT_TIMER_START(timer);
+    for (int i = 0; i < count; i++) {
+        int u = queries[i].u, v = queries[i].v, w = queries[i].weight;
+        
+        if (u == v) {
+            // A self-loop never belongs to a spanning tree
+            answers[i].inSomeMST = false;
+            answers[i].inEveryMST = false;
+        } else if (index->component[u] != index->component[v]) {
+            // Nothing else joins the two sides: the edge is a bridge
+            answers[i].inSomeMST = true;
+            answers[i].inEveryMST = true;
+        } else if ((index->up[u] == v && index->depth[u] > index->depth[v] && index->upMax[u] == w) ||
+                   (index->up[v] == u && index->depth[v] > index->depth[u] && index->upMax[v] == w)) {
+            // A tree edge is in every MST unless an equally light edge can replace it
+            int child = index->depth[u] > index->depth[v] ? u : v;
+            answers[i].inSomeMST = true;
+            answers[i].inEveryMST = index->replacement[child] > w;
+        } else {
+            // Any other edge closes a cycle with the tree path. Lighter than
+            // the path's heaviest edge, it must replace that edge in every
+            // MST; equally heavy, it can swap in for it; heavier, never.
+            int pathMax = pathMaxWeight(index, u, v);
+            answers[i].inSomeMST = w <= pathMax;
+            answers[i].inEveryMST = w < pathMax;
+        }
+    }
+    STAT_TIMER_STOP(timer, "queryEdgesInMST");
+}
+
+// Classify every edge of a graph file against an MST index
+int runGraphFile(const char* path) {
+    MappedGraph file;
+    if (!openGraphFile(path, &file)) {
+        fprintf(stderr, "Could not read a graph from %s\n", path);
+        return 1;
+    }
+    
+    MSTIndex* index = buildMSTIndex(graphFileCSR(&file));
+    EdgeQuery* queries = (EdgeQuery*)calloc(file.E > 0 ? file.E : 1, sizeof(EdgeQuery));
+    EdgeMembership* answers = (EdgeMembership*)malloc((file.E > 0 ? file.E : 1) * sizeof(EdgeMembership));
+    for (int i = 0; i < file.E; i++) {
+        queries[i].u = file.edges[i].src;
+        queries[i].v = file.edges[i].dest;
+        queries[i].weight = file.edges[i].weight;
+    }
+    queryEdgesInMST(index, queries, file.E, answers);
+    
+    int every = 0, some = 0;
+    for (int i = 0; i < file.E; i++) {
+        if (answers[i].inEveryMST) every++;
+        else if (answers[i].inSomeMST) some++;
+    }
+    printf("%d edges: %d in every MST, %d in some MST, %d in no MST\n",
+           file.E, every, some, file.E - every - some);
+    
+    free(queries);
+    free(answers);
+    freeMSTIndex(index);
+    closeGraphFile(&file);
+    return 0;
+}
+
+#ifndef MST_LIBRARY_ONLY
+int main(int argc, char** argv) {
+    // --stats dumps the operation counters as JSON on stderr at exit
+    bool stats = mstStatsTakeFlag(&argc, argv);
+    
+    // Run on a graph file (binary or text) when one is given
+    if (argc > 1) {
+        int status = runGraphFile(argv[1]);
+        if (stats)
+            mstStatsPrintJSON(stderr);
+        return status;
+    }
+    
+    // Create a sample graph
+    GraphEdge edges[] = {
+        {0, 1, 2},
+        {0, 3, 6},
+        {1, 2, 3},
+        {1, 3, 8},
+        {1, 4, 5},
+        {2, 4, 7},
+        {3, 4, 9},
+    };
+    CSRGraph* graph = buildCSRGraph(5, edges, sizeof(edges) / sizeof(edges[0]));
     
     // Check if edge (0, 1) is in MST
     int u = 0, v = 1;
@@ -414,17 +578,34 @@ int main() {
     inMST_Prim = isEdgeInMST_Prim(graph, u, v);
     printf("Method 3 (Prim's): %s\n", inMST_Prim ? "Yes" : "No");
     
-    // Free the graph
-    for (int i = 0; i < graph->V; i++) {
-        Edge* temp = graph->adjList[i];
-        while (temp) {
-            Edge* next = temp->next;
-            free(temp);
-            temp = next;
-        }
+    // Method 4: Answer every edge of the graph in one batch against an MST index
+    MSTIndex* index = buildMSTIndex(graph);
+    int queryCount = sizeof(edges) / sizeof(edges[0]);
+    EdgeQuery* queries = (EdgeQuery*)malloc(queryCount * sizeof(EdgeQuery));
+    EdgeMembership* answers = (EdgeMembership*)malloc(queryCount * sizeof(EdgeMembership));
+    for (int i = 0; i < queryCount; i++) {
+        queries[i].u = edges[i].src;
+        queries[i].v = edges[i].dest;
+        queries[i].weight = edges[i].weight;
     }
-    free(graph->adjList);
-    free(graph);
+    queryEdgesInMST(index, queries, queryCount, answers);
+    
+    printf("\nMethod 4 (MST index), all edges:\n");
+    for (int i = 0; i < queryCount; i++) {
+        printf("Edge (%d, %d) weight %d: %s\n", queries[i].u, queries[i].v, queries[i].weight,
+               answers[i].inEveryMST ? "in every MST" :
+               answers[i].inSomeMST ? "in some MST" : "in no MST");
+    }
+    
+    free(queries);
+    free(answers);
+    freeMSTIndex(index);
+    
+    // Free the graph
+    freeCSRGraph(graph);
     
+    if (stats)
+        mstStatsPrintJSON(stderr);
     return 0;
 }
+#endif // MST_LIBRARY_ONLY
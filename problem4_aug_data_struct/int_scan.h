@@ -0,0 +1,252 @@
+#ifndef INT_SCAN_H
+#define INT_SCAN_H
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Linear scans over int arrays: maximum, first index of a value and number
+// of occurrences of a value. Each scan has a scalar version and, on x86,
+// SSE4.2, AVX2 and AVX-512 versions compiled with per-function target
+// attributes. intScanKernels() picks the widest one the CPU supports on
+// first use; INT_SCAN_ISA=scalar|sse4.2|avx2|avx512 in the environment
+// forces a narrower one.
+
+typedef struct {
+    const char *name;
+    int (*max)(const int *data, size_t n);                    // n must be > 0
+    ptrdiff_t (*findFirst)(const int *data, size_t n, int value); // -1 if absent
+    size_t (*count)(const int *data, size_t n, int value);
+} IntScanKernels;
+
+static int scalarMax(const int *data, size_t n) {
+    int max = data[0];
+    for (size_t i = 1; i < n; i++)
+        if (data[i] > max)
+            max = data[i];
+    return max;
+}
+
+static ptrdiff_t scalarFindFirst(const int *data, size_t n, int value) {
+    for (size_t i = 0; i < n; i++)
+        if (data[i] == value)
+            return (ptrdiff_t)i;
+    return -1;
+}
+
+static size_t scalarCount(const int *data, size_t n, int value) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; i++)
+        count += data[i] == value;
+    return count;
+}
+
+static const IntScanKernels intScanScalar = {"scalar", scalarMax, scalarFindFirst, scalarCount};
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define INT_SCAN_X86 1
+
+// SSE4.2: 4 lanes, four vectors per iteration so the loads stay in flight
+
+__attribute__((target("sse4.2")))
+static int sse42Max(const int *data, size_t n) {
+    if (n < 16) return scalarMax(data, n);
+    __m128i m0 = _mm_loadu_si128((const __m128i *)data), m1 = m0, m2 = m0, m3 = m0;
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        m0 = _mm_max_epi32(m0, _mm_loadu_si128((const __m128i *)(data + i)));
+        m1 = _mm_max_epi32(m1, _mm_loadu_si128((const __m128i *)(data + i + 4)));
+        m2 = _mm_max_epi32(m2, _mm_loadu_si128((const __m128i *)(data + i + 8)));
+        m3 = _mm_max_epi32(m3, _mm_loadu_si128((const __m128i *)(data + i + 12)));
+    }
+    m0 = _mm_max_epi32(_mm_max_epi32(m0, m1), _mm_max_epi32(m2, m3));
+    m0 = _mm_max_epi32(m0, _mm_shuffle_epi32(m0, _MM_SHUFFLE(1, 0, 3, 2)));
+    m0 = _mm_max_epi32(m0, _mm_shuffle_epi32(m0, _MM_SHUFFLE(2, 3, 0, 1)));
+    int max = _mm_cvtsi128_si32(m0);
+    for (; i < n; i++)
+        if (data[i] > max)
+            max = data[i];
+    return max;
+}
+
+__attribute__((target("sse4.2")))
+static ptrdiff_t sse42FindFirst(const int *data, size_t n, int value) {
+    __m128i v = _mm_set1_epi32(value);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i e0 = _mm_cmpeq_epi32(v, _mm_loadu_si128((const __m128i *)(data + i)));
+        __m128i e1 = _mm_cmpeq_epi32(v, _mm_loadu_si128((const __m128i *)(data + i + 4)));
+        __m128i e2 = _mm_cmpeq_epi32(v, _mm_loadu_si128((const __m128i *)(data + i + 8)));
+        __m128i e3 = _mm_cmpeq_epi32(v, _mm_loadu_si128((const __m128i *)(data + i + 12)));
+        __m128i any = _mm_or_si128(_mm_or_si128(e0, e1), _mm_or_si128(e2, e3));
+        if (!_mm_testz_si128(any, any)) {
+            unsigned mask = (unsigned)_mm_movemask_ps(_mm_castsi128_ps(e0))
+                | (unsigned)_mm_movemask_ps(_mm_castsi128_ps(e1)) << 4
+                | (unsigned)_mm_movemask_ps(_mm_castsi128_ps(e2)) << 8
+                | (unsigned)_mm_movemask_ps(_mm_castsi128_ps(e3)) << 12;
+            return (ptrdiff_t)(i + __builtin_ctz(mask));
+        }
+    }
+    ptrdiff_t rest = scalarFindFirst(data + i, n - i, value);
+    return rest < 0 ? -1 : (ptrdiff_t)i + rest;
+}
+
+__attribute__((target("sse4.2")))
+static size_t sse42Count(const int *data, size_t n, int value) {
+    __m128i v = _mm_set1_epi32(value);
+    size_t count = 0, i = 0;
+    // Matches are -1 per lane; flush the lane sums before they can overflow
+    while (i + 4 <= n) {
+        size_t end = n - i > ((size_t)1 << 30) ? i + ((size_t)1 << 30) : n;
+        __m128i acc = _mm_setzero_si128();
+        for (; i + 4 <= end; i += 4)
+            acc = _mm_sub_epi32(acc, _mm_cmpeq_epi32(v, _mm_loadu_si128((const __m128i *)(data + i))));
+        acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+        acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+        count += (unsigned)_mm_cvtsi128_si32(acc);
+    }
+    return count + scalarCount(data + i, n - i, value);
+}
+
+// AVX2: 8 lanes
+
+__attribute__((target("avx2")))
+static int avx2Max(const int *data, size_t n) {
+    if (n < 32) return scalarMax(data, n);
+    __m256i m0 = _mm256_loadu_si256((const __m256i *)data), m1 = m0, m2 = m0, m3 = m0;
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        m0 = _mm256_max_epi32(m0, _mm256_loadu_si256((const __m256i *)(data + i)));
+        m1 = _mm256_max_epi32(m1, _mm256_loadu_si256((const __m256i *)(data + i + 8)));
+        m2 = _mm256_max_epi32(m2, _mm256_loadu_si256((const __m256i *)(data + i + 16)));
+        m3 = _mm256_max_epi32(m3, _mm256_loadu_si256((const __m256i *)(data + i + 24)));
+    }
+    m0 = _mm256_max_epi32(_mm256_max_epi32(m0, m1), _mm256_max_epi32(m2, m3));
+    __m128i h = _mm_max_epi32(_mm256_castsi256_si128(m0), _mm256_extracti128_si256(m0, 1));
+    h = _mm_max_epi32(h, _mm_shuffle_epi32(h, _MM_SHUFFLE(1, 0, 3, 2)));
+    h = _mm_max_epi32(h, _mm_shuffle_epi32(h, _MM_SHUFFLE(2, 3, 0, 1)));
+    int max = _mm_cvtsi128_si32(h);
+    for (; i < n; i++)
+        if (data[i] > max)
+            max = data[i];
+    return max;
+}
+
+__attribute__((target("avx2")))
+static ptrdiff_t avx2FindFirst(const int *data, size_t n, int value) {
+    __m256i v = _mm256_set1_epi32(value);
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i e0 = _mm256_cmpeq_epi32(v, _mm256_loadu_si256((const __m256i *)(data + i)));
+        __m256i e1 = _mm256_cmpeq_epi32(v, _mm256_loadu_si256((const __m256i *)(data + i + 8)));
+        __m256i e2 = _mm256_cmpeq_epi32(v, _mm256_loadu_si256((const __m256i *)(data + i + 16)));
+        __m256i e3 = _mm256_cmpeq_epi32(v, _mm256_loadu_si256((const __m256i *)(data + i + 24)));
+        __m256i any = _mm256_or_si256(_mm256_or_si256(e0, e1), _mm256_or_si256(e2, e3));
+        if (!_mm256_testz_si256(any, any)) {
+            unsigned mask = (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(e0))
+                | (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(e1)) << 8
+                | (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(e2)) << 16
+                | (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(e3)) << 24;
+            return (ptrdiff_t)(i + __builtin_ctz(mask));
+        }
+    }
+    ptrdiff_t rest = scalarFindFirst(data + i, n - i, value);
+    return rest < 0 ? -1 : (ptrdiff_t)i + rest;
+}
+
+__attribute__((target("avx2")))
+static size_t avx2Count(const int *data, size_t n, int value) {
+    __m256i v = _mm256_set1_epi32(value);
+    size_t count = 0, i = 0;
+    while (i + 8 <= n) {
+        size_t end = n - i > ((size_t)1 << 30) ? i + ((size_t)1 << 30) : n;
+        __m256i acc = _mm256_setzero_si256();
+        for (; i + 8 <= end; i += 8)
+            acc = _mm256_sub_epi32(acc, _mm256_cmpeq_epi32(v, _mm256_loadu_si256((const __m256i *)(data + i))));
+        __m128i h = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+        h = _mm_add_epi32(h, _mm_shuffle_epi32(h, _MM_SHUFFLE(1, 0, 3, 2)));
+        h = _mm_add_epi32(h, _mm_shuffle_epi32(h, _MM_SHUFFLE(2, 3, 0, 1)));
+        count += (unsigned)_mm_cvtsi128_si32(h);
+    }
+    return count + scalarCount(data + i, n - i, value);
+}
+
+// AVX-512: 16 lanes with mask registers, so tails need no scalar loop
+
+__attribute__((target("avx512f")))
+static int avx512Max(const int *data, size_t n) {
+    __m512i m = _mm512_set1_epi32(data[0]);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+        m = _mm512_max_epi32(m, _mm512_loadu_si512(data + i));
+    if (i < n) {
+        __mmask16 tail = (__mmask16)((1u << (n - i)) - 1);
+        m = _mm512_mask_max_epi32(m, tail, m, _mm512_maskz_loadu_epi32(tail, data + i));
+    }
+    return _mm512_reduce_max_epi32(m);
+}
+
+__attribute__((target("avx512f")))
+static ptrdiff_t avx512FindFirst(const int *data, size_t n, int value) {
+    __m512i v = _mm512_set1_epi32(value);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __mmask16 eq = _mm512_cmpeq_epi32_mask(v, _mm512_loadu_si512(data + i));
+        if (eq) return (ptrdiff_t)(i + __builtin_ctz(eq));
+    }
+    if (i < n) {
+        __mmask16 tail = (__mmask16)((1u << (n - i)) - 1);
+        __mmask16 eq = _mm512_mask_cmpeq_epi32_mask(tail, v, _mm512_maskz_loadu_epi32(tail, data + i));
+        if (eq) return (ptrdiff_t)(i + __builtin_ctz(eq));
+    }
+    return -1;
+}
+
+__attribute__((target("avx512f")))
+static size_t avx512Count(const int *data, size_t n, int value) {
+    __m512i v = _mm512_set1_epi32(value);
+    size_t count = 0, i = 0;
+    for (; i + 16 <= n; i += 16)
+        count += __builtin_popcount(_mm512_cmpeq_epi32_mask(v, _mm512_loadu_si512(data + i)));
+    if (i < n) {
+        __mmask16 tail = (__mmask16)((1u << (n - i)) - 1);
+        count += __builtin_popcount(_mm512_mask_cmpeq_epi32_mask(tail, v, _mm512_maskz_loadu_epi32(tail, data + i)));
+    }
+    return count;
+}
+
+static const IntScanKernels intScanSse42 = {"sse4.2", sse42Max, sse42FindFirst, sse42Count};
+static const IntScanKernels intScanAvx2 = {"avx2", avx2Max, avx2FindFirst, avx2Count};
+static const IntScanKernels intScanAvx512 = {"avx512", avx512Max, avx512FindFirst, avx512Count};
+#endif
+
+// Every kernel set this CPU can run, narrowest first. Returns the count.
+static int intScanAvailable(const IntScanKernels **out) {
+    int n = 0;
+    out[n++] = &intScanScalar;
+#ifdef INT_SCAN_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2")) out[n++] = &intScanSse42;
+    if (__builtin_cpu_supports("avx2")) out[n++] = &intScanAvx2;
+    if (__builtin_cpu_supports("avx512f")) out[n++] = &intScanAvx512;
+#endif
+    return n;
+}
+
+// The kernel set used by IntList, chosen once
+static const IntScanKernels *intScanKernels(void) {
+    static const IntScanKernels *selected = NULL;
+    if (!selected) {
+        const IntScanKernels *available[4];
+        int n = intScanAvailable(available);
+        selected = available[n - 1];
+        const char *forced = getenv("INT_SCAN_ISA");
+        for (int i = 0; forced && i < n; i++)
+            if (strcmp(available[i]->name, forced) == 0)
+                selected = available[i];
+    }
+    return selected;
+}
+
+#endif // INT_SCAN_H
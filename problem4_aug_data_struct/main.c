@@ -1,16 +1,246 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
+#include "int_scan.h"
+#include "../common/radix_sort.h"
+#include "../common/dsu.h"
+#include "../common/graph_file.h"
+
+typedef enum {
+    LIST_ARRAY,     // Insertion-ordered array, best for small lists
+    LIST_TREE       // Order-statistic AVL tree, O(log n) updates and queries
+} ListKind;
+
+// AVL node stored in a pool; links are pool indices, -1 for none
 typedef struct {
+    int value;
+    int left, right;
+    int height;
+    int count;      // Nodes in this subtree
+} TreeNode;
+
+// The tree variant keeps its values sorted (ascending unless
+// sortDescending was called), so get(i) is the i-th value in that order
+typedef struct {
+    ListKind kind;
     int *data;
     int size;
     int capacity;
+    TreeNode *nodes;
+    int root;
+    int freeNode;   // Head of the free-node chain, linked through left
+    int used;       // Pool slots handed out so far
+    int descending;
+    int sorted;     // Array order: 1 ascending, -1 descending, 0 unknown
 } IntList;
 
-void initList(IntList *list) {
-    list->capacity = 4;
+void initListKind(IntList *list, ListKind kind) {
+    list->kind = kind;
     list->size = 0;
-    list->data = (int *)malloc(sizeof(int) * list->capacity);
+    list->root = -1;
+    list->freeNode = -1;
+    list->used = 0;
+    list->descending = 0;
+    list->sorted = 1;
+    list->capacity = 4;
+    if (kind == LIST_TREE) {
+        list->data = NULL;
+        list->nodes = (TreeNode *)malloc(sizeof(TreeNode) * list->capacity);
+    } else {
+        list->data = (int *)malloc(sizeof(int) * list->capacity);
+        list->nodes = NULL;
+    }
+}
+
+void initList(IntList *list) {
+    initListKind(list, LIST_ARRAY);
+}
+
+static int treeHeight(IntList *list, int n) {
+    return n == -1 ? 0 : list->nodes[n].height;
+}
+
+static int treeCount(IntList *list, int n) {
+    return n == -1 ? 0 : list->nodes[n].count;
+}
+
+static void treeUpdate(IntList *list, int n) {
+    TreeNode *node = &list->nodes[n];
+    int hl = treeHeight(list, node->left), hr = treeHeight(list, node->right);
+    node->height = 1 + (hl > hr ? hl : hr);
+    node->count = 1 + treeCount(list, node->left) + treeCount(list, node->right);
+}
+
+static int treeRotateRight(IntList *list, int n) {
+    int l = list->nodes[n].left;
+    list->nodes[n].left = list->nodes[l].right;
+    list->nodes[l].right = n;
+    treeUpdate(list, n);
+    treeUpdate(list, l);
+    return l;
+}
+
+static int treeRotateLeft(IntList *list, int n) {
+    int r = list->nodes[n].right;
+    list->nodes[n].right = list->nodes[r].left;
+    list->nodes[r].left = n;
+    treeUpdate(list, n);
+    treeUpdate(list, r);
+    return r;
+}
+
+// Restore the AVL invariant at n and return the subtree's new root
+static int treeBalance(IntList *list, int n) {
+    treeUpdate(list, n);
+    TreeNode *node = &list->nodes[n];
+    int balance = treeHeight(list, node->left) - treeHeight(list, node->right);
+    if (balance > 1) {
+        int l = node->left;
+        if (treeHeight(list, list->nodes[l].left) < treeHeight(list, list->nodes[l].right))
+            list->nodes[n].left = treeRotateLeft(list, l);
+        return treeRotateRight(list, n);
+    }
+    if (balance < -1) {
+        int r = node->right;
+        if (treeHeight(list, list->nodes[r].right) < treeHeight(list, list->nodes[r].left))
+            list->nodes[n].right = treeRotateRight(list, r);
+        return treeRotateLeft(list, n);
+    }
+    return n;
+}
+
+static int treeNewNode(IntList *list, int value) {
+    int n;
+    if (list->freeNode != -1) {
+        n = list->freeNode;
+        list->freeNode = list->nodes[n].left;
+    } else {
+        if (list->used == list->capacity) {
+            list->capacity *= 2;
+            list->nodes = (TreeNode *)realloc(list->nodes, sizeof(TreeNode) * list->capacity);
+        }
+        n = list->used++;
+    }
+    list->nodes[n].value = value;
+    list->nodes[n].left = list->nodes[n].right = -1;
+    list->nodes[n].height = 1;
+    list->nodes[n].count = 1;
+    return n;
+}
+
+static void treeFreeNode(IntList *list, int n) {
+    list->nodes[n].left = list->freeNode;
+    list->freeNode = n;
+}
+
+// Insert value into subtree n and return its new root
+static int treeInsert(IntList *list, int n, int value) {
+    if (n == -1)
+        return treeNewNode(list, value);
+    if (value < list->nodes[n].value) {
+        int l = treeInsert(list, list->nodes[n].left, value);
+        list->nodes[n].left = l;
+    } else {
+        int r = treeInsert(list, list->nodes[n].right, value);
+        list->nodes[n].right = r;
+    }
+    return treeBalance(list, n);
+}
+
+// Unlink the smallest node of subtree n into *min
+static int treeRemoveMin(IntList *list, int n, int *min) {
+    if (list->nodes[n].left == -1) {
+        *min = n;
+        return list->nodes[n].right;
+    }
+    int l = treeRemoveMin(list, list->nodes[n].left, min);
+    list->nodes[n].left = l;
+    return treeBalance(list, n);
+}
+
+static int treeRemove(IntList *list, int n, int value, int *removed) {
+    if (n == -1)
+        return -1;
+    if (value < list->nodes[n].value) {
+        int l = treeRemove(list, list->nodes[n].left, value, removed);
+        list->nodes[n].left = l;
+    } else if (value > list->nodes[n].value) {
+        int r = treeRemove(list, list->nodes[n].right, value, removed);
+        list->nodes[n].right = r;
+    } else {
+        *removed = 1;
+        int l = list->nodes[n].left, r = list->nodes[n].right;
+        treeFreeNode(list, n);
+        if (r == -1)
+            return l;
+        int min;
+        r = treeRemoveMin(list, r, &min);
+        list->nodes[min].left = l;
+        list->nodes[min].right = r;
+        return treeBalance(list, min);
+    }
+    return treeBalance(list, n);
+}
+
+// Value of rank k (0-based) in ascending order
+static int treeKth(IntList *list, int k) {
+    int n = list->root;
+    for (;;) {
+        int leftCount = treeCount(list, list->nodes[n].left);
+        if (k < leftCount) {
+            n = list->nodes[n].left;
+        } else if (k == leftCount) {
+            return list->nodes[n].value;
+        } else {
+            k -= leftCount + 1;
+            n = list->nodes[n].right;
+        }
+    }
+}
+
+static void treePrint(IntList *list, int n) {
+    if (n == -1) return;
+    TreeNode *node = &list->nodes[n];
+    treePrint(list, list->descending ? node->right : node->left);
+    printf("%d ", node->value);
+    treePrint(list, list->descending ? node->left : node->right);
+}
+
+// Append the subtree's values to out in ascending order
+static void treeCollect(IntList *list, int n, int *out, int *k) {
+    if (n == -1) return;
+    treeCollect(list, list->nodes[n].left, out, k);
+    out[(*k)++] = list->nodes[n].value;
+    treeCollect(list, list->nodes[n].right, out, k);
+}
+
+// Perfectly balanced subtree over the sorted values[lo..hi)
+static int treeBuild(IntList *list, const int *values, int lo, int hi) {
+    if (lo >= hi) return -1;
+    int mid = lo + (hi - lo) / 2;
+    int n = treeNewNode(list, values[mid]);
+    int l = treeBuild(list, values, lo, mid);
+    int r = treeBuild(list, values, mid + 1, hi);
+    list->nodes[n].left = l;
+    list->nodes[n].right = r;
+    treeUpdate(list, n);
+    return n;
+}
+
+// Replace the tree with one over the sorted values, in a pool of
+// exactly capacity slots
+static void treeRebuild(IntList *list, const int *values, int count, int capacity) {
+    if (capacity < 1) capacity = 1;
+    if (capacity != list->capacity) {
+        free(list->nodes);
+        list->nodes = (TreeNode *)malloc(sizeof(TreeNode) * capacity);
+        list->capacity = capacity;
+    }
+    list->freeNode = -1;
+    list->used = 0;
+    list->root = treeBuild(list, values, 0, count);
+    list->size = count;
 }
 
 void resizeList(IntList *list) {
@@ -19,24 +249,179 @@ void resizeList(IntList *list) {
 }
 
 void insert(IntList *list, int value) {
+    if (list->kind == LIST_TREE) {
+        list->root = treeInsert(list, list->root, value);
+        list->size++;
+        return;
+    }
+    if (list->size > 0) {
+        int last = list->data[list->size - 1];
+        if ((list->sorted > 0 && value < last) || (list->sorted < 0 && value > last))
+            list->sorted = 0;
+    }
     if (list->size == list->capacity)
         resizeList(list);
     list->data[list->size++] = value;
 }
 
 int removeItem(IntList *list, int value) {
-    for (int i = 0; i < list->size; i++) {
-        if (list->data[i] == value) {
-            for (int j = i; j < list->size - 1; j++)
-                list->data[j] = list->data[j + 1];
-            list->size--;
-            return 1;
+    if (list->kind == LIST_TREE) {
+        int removed = 0;
+        list->root = treeRemove(list, list->root, value, &removed);
+        list->size -= removed;
+        return removed;
+    }
+    ptrdiff_t i = intScanKernels()->findFirst(list->data, list->size, value);
+    if (i < 0) return 0;
+    memmove(list->data + i, list->data + i + 1, sizeof(int) * (list->size - 1 - i));
+    list->size--;
+    return 1;
+}
+
+// Make room for at least capacity values (tree: pool nodes)
+void reserve(IntList *list, int capacity) {
+    if (capacity <= list->capacity) return;
+    list->capacity = capacity;
+    if (list->kind == LIST_TREE)
+        list->nodes = (TreeNode *)realloc(list->nodes, sizeof(TreeNode) * capacity);
+    else
+        list->data = (int *)realloc(list->data, sizeof(int) * capacity);
+}
+
+// Release unused capacity. The tree is rebuilt balanced into a pool
+// with one slot per value.
+void shrinkToFit(IntList *list) {
+    int capacity = list->size > 0 ? list->size : 1;
+    if (list->kind == LIST_TREE) {
+        int *values = (int *)malloc(sizeof(int) * capacity), k = 0;
+        treeCollect(list, list->root, values, &k);
+        treeRebuild(list, values, list->size, capacity);
+        free(values);
+        return;
+    }
+    list->capacity = capacity;
+    list->data = (int *)realloc(list->data, sizeof(int) * capacity);
+}
+
+// Append count values with at most one reallocation. A tree receiving
+// many values at once is merged and rebuilt instead of inserted into.
+void insertMany(IntList *list, const int *values, int count) {
+    if (count <= 0) return;
+    if (list->kind == LIST_TREE) {
+        if (count < list->size / 16 + 16) {
+            for (int i = 0; i < count; i++)
+                insert(list, values[i]);
+            return;
         }
+        int total = list->size + count, k = 0;
+        int *all = (int *)malloc(sizeof(int) * total);
+        treeCollect(list, list->root, all, &k);
+        memcpy(all + k, values, sizeof(int) * count);
+        radixSortInt32(all, total);
+        treeRebuild(list, all, total, total > list->capacity ? total : list->capacity);
+        free(all);
+        return;
     }
-    return 0;
+    if (list->size + count > list->capacity)
+        reserve(list, list->size + count > 2 * list->capacity ? list->size + count : 2 * list->capacity);
+    int *dst = list->data + list->size;
+    memcpy(dst, values, sizeof(int) * count);
+    for (int i = list->size > 0 ? -1 : 0; list->sorted != 0 && i + 1 < count; i++) {
+        if ((list->sorted > 0 && dst[i + 1] < dst[i]) || (list->sorted < 0 && dst[i + 1] > dst[i]))
+            list->sorted = 0;
+    }
+    list->size += count;
+}
+
+// Open-addressing hash set of ints for removeMany
+typedef struct {
+    int *keys;
+    unsigned char *used;
+    unsigned mask;
+} IntSet;
+
+static unsigned intSetSlot(IntSet *set, int value) {
+    unsigned h = (unsigned)value * 0x9E3779B9u;
+    h ^= h >> 16;
+    for (h &= set->mask; set->used[h] && set->keys[h] != value; h = (h + 1) & set->mask)
+        ;
+    return h;
+}
+
+static void intSetInit(IntSet *set, const int *values, int count) {
+    unsigned slots = 16;
+    while (slots < 2u * (unsigned)count) slots *= 2;
+    set->keys = (int *)malloc(sizeof(int) * slots);
+    set->used = (unsigned char *)calloc(slots, 1);
+    set->mask = slots - 1;
+    for (int i = 0; i < count; i++) {
+        unsigned h = intSetSlot(set, values[i]);
+        set->used[h] = 1;
+        set->keys[h] = values[i];
+    }
+}
+
+static int intSetHas(IntSet *set, int value) {
+    return set->used[intSetSlot(set, value)];
+}
+
+static void intSetFree(IntSet *set) {
+    free(set->keys);
+    free(set->used);
+}
+
+// Remove every occurrence of each of the count values; the array is
+// compacted in one pass. Returns the number of values removed.
+int removeMany(IntList *list, const int *values, int count) {
+    int before = list->size;
+    if (count <= 0 || before == 0) return 0;
+    if (list->kind == LIST_TREE) {
+        for (int i = 0; i < count; i++) {
+            int removed = 1;
+            while (removed) {
+                removed = 0;
+                list->root = treeRemove(list, list->root, values[i], &removed);
+                list->size -= removed;
+            }
+        }
+        return before - list->size;
+    }
+    IntSet set;
+    intSetInit(&set, values, count);
+    int kept = 0;
+    for (int i = 0; i < list->size; i++)
+        if (!intSetHas(&set, list->data[i]))
+            list->data[kept++] = list->data[i];
+    intSetFree(&set);
+    list->size = kept;
+    return before - kept;
+}
+
+// Remove every value for which drop(value, context) is nonzero, in one
+// pass. Returns the number of values removed.
+int removeIf(IntList *list, int (*drop)(int value, void *context), void *context) {
+    int before = list->size, kept = 0;
+    if (before == 0) return 0;
+    if (list->kind == LIST_TREE) {
+        int *values = (int *)malloc(sizeof(int) * before), k = 0;
+        treeCollect(list, list->root, values, &k);
+        for (int i = 0; i < k; i++)
+            if (!drop(values[i], context))
+                values[kept++] = values[i];
+        treeRebuild(list, values, kept, list->capacity);
+        free(values);
+        return before - kept;
+    }
+    for (int i = 0; i < list->size; i++)
+        if (!drop(list->data[i], context))
+            list->data[kept++] = list->data[i];
+    list->size = kept;
+    return before - kept;
 }
 
 int get(IntList *list, int index) {
+    if (index >= 0 && index < list->size && list->kind == LIST_TREE)
+        return treeKth(list, list->descending ? list->size - 1 - index : index);
     if (index >= 0 && index < list->size)
         return list->data[index];
     printf("Index out of bounds\n");
@@ -53,45 +438,373 @@ int isEmpty(IntList *list) {
 
 void clear(IntList *list) {
     list->size = 0;
+    list->root = -1;
+    list->freeNode = -1;
+    list->used = 0;
+    list->sorted = 1;
 }
 
 void printList(IntList *list) {
+    if (list->kind == LIST_TREE) {
+        treePrint(list, list->root);
+        printf("\n");
+        return;
+    }
     for (int i = 0; i < list->size; i++)
         printf("%d ", list->data[i]);
     printf("\n");
 }
 
 int compareAsc(const void *a, const void *b) {
-    return (*(int *)a - *(int *)b);
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
 }
 
 int compareDesc(const void *a, const void *b) {
-    return (*(int *)b - *(int *)a);
+    return compareAsc(b, a);
+}
+
+static void reverseData(IntList *list) {
+    for (int i = 0, j = list->size - 1; i < j; i++, j--) {
+        int t = list->data[i];
+        list->data[i] = list->data[j];
+        list->data[j] = t;
+    }
 }
 
 void sortAscending(IntList *list) {
-    qsort(list->data, list->size, sizeof(int), compareAsc);
+    if (list->kind == LIST_TREE) {
+        list->descending = 0;
+        return;
+    }
+    // Already sorted one way or the other: nothing to do, or a reversal
+    if (list->sorted < 0)
+        reverseData(list);
+    else if (list->sorted == 0)
+        radixSortInt32(list->data, list->size);
+    list->sorted = 1;
 }
 
 void sortDescending(IntList *list) {
-    qsort(list->data, list->size, sizeof(int), compareDesc);
+    if (list->kind == LIST_TREE) {
+        list->descending = 1;
+        return;
+    }
+    if (list->sorted == 0)
+        radixSortInt32(list->data, list->size);
+    if (list->sorted >= 0)
+        reverseData(list);
+    list->sorted = -1;
 }
 
 int findMax(IntList *list) {
     if (list->size == 0) return -1;
-    int max = list->data[0];
-    for (int i = 1; i < list->size; i++)
-        if (list->data[i] > max)
-            max = list->data[i];
-    return max;
+    if (list->kind == LIST_TREE) {
+        int n = list->root;
+        while (list->nodes[n].right != -1)
+            n = list->nodes[n].right;
+        return list->nodes[n].value;
+    }
+    return intScanKernels()->max(list->data, list->size);
+}
+
+// Number of values strictly smaller than value
+int rankOf(IntList *list, int value) {
+    int rank = 0;
+    if (list->kind == LIST_TREE) {
+        int n = list->root;
+        while (n != -1) {
+            if (list->nodes[n].value < value) {
+                rank += treeCount(list, list->nodes[n].left) + 1;
+                n = list->nodes[n].right;
+            } else {
+                n = list->nodes[n].left;
+            }
+        }
+        return rank;
+    }
+    for (int i = 0; i < list->size; i++)
+        if (list->data[i] < value)
+            rank++;
+    return rank;
+}
+
+// Number of values equal to value
+int countOf(IntList *list, int value) {
+    if (list->kind == LIST_TREE) {
+        int atMost = 0, n = list->root;
+        while (n != -1) {
+            if (list->nodes[n].value <= value) {
+                atMost += treeCount(list, list->nodes[n].left) + 1;
+                n = list->nodes[n].right;
+            } else {
+                n = list->nodes[n].left;
+            }
+        }
+        return atMost - rankOf(list, value);
+    }
+    return (int)intScanKernels()->count(list->data, list->size, value);
+}
+
+// k-th smallest value (0-based) regardless of the list order
+int kthSmallest(IntList *list, int k) {
+    if (k < 0 || k >= list->size) {
+        printf("Index out of bounds\n");
+        return -1;
+    }
+    if (list->kind == LIST_TREE)
+        return treeKth(list, k);
+
+    // Quickselect on a copy so the array keeps its order
+    int *copy = (int *)malloc(sizeof(int) * list->size);
+    for (int i = 0; i < list->size; i++)
+        copy[i] = list->data[i];
+    int lo = 0, hi = list->size - 1;
+    while (lo < hi) {
+        int pivot = copy[lo + (hi - lo) / 2], i = lo, j = hi;
+        while (i <= j) {
+            while (copy[i] < pivot) i++;
+            while (copy[j] > pivot) j--;
+            if (i <= j) {
+                int t = copy[i]; copy[i] = copy[j]; copy[j] = t;
+                i++;
+                j--;
+            }
+        }
+        if (k <= j) hi = j;
+        else if (k >= i) lo = i;
+        else break;
+    }
+    int value = copy[k];
+    free(copy);
+    return value;
 }
 
 void freeList(IntList *list) {
     free(list->data);
+    free(list->nodes);
     list->data = NULL;
+    list->nodes = NULL;
+}
+
+// Endpoint of edge e other than v
+static int otherEnd(const GraphEdge *edges, int e, int v) {
+    return edges[e].src == v ? edges[e].dest : edges[e].src;
+}
+
+// Edge order shared with Kruskal: by weight, ties by index
+static int heavier(const GraphEdge *edges, int a, int b) {
+    if (edges[a].weight != edges[b].weight)
+        return edges[a].weight > edges[b].weight;
+    return a > b;
+}
+
+// Follow the chain of degree-2 vertices that starts at v with edge e.
+// Any cycle through one chain edge runs through the whole chain, so every
+// edge but the heaviest is in the MST and goes to tree. Returns the
+// heaviest edge and stores the vertex where the chain ends.
+static int walkChain(const IntList *arcs, const int *start, const GraphEdge *edges, const int *degree,
+                     char *state, int v, int e, int *end, int *tree, int *treeSize) {
+    int heaviest = e;
+    state[e] = 2;
+    v = otherEnd(edges, e, v);
+    while (degree[v] == 2) {
+        int next = -1;
+        for (int i = start[v]; i < start[v + 1] && next == -1; i++)
+            if (state[arcs->data[i]] == 0)
+                next = arcs->data[i];
+        if (next == -1) break;  // Back where a pure cycle started
+        if (heavier(edges, next, heaviest)) {
+            tree[(*treeSize)++] = heaviest;
+            heaviest = next;
+        } else {
+            tree[(*treeSize)++] = next;
+        }
+        state[next] = 2;
+        v = otherEnd(edges, next, v);
+    }
+    *end = v;
+    return heaviest;
+}
+
+// Minimum spanning forest of a graph with E = V - 1 + k edges for small k,
+// in O(V + E + k log k). Writes the chosen edge indices to tree (room for
+// V - 1) and returns how many there are; fewer than V - 1 means the graph
+// is disconnected. Ties break by edge index, as in Kruskal.
+//
+// Leaves are peeled first: a leaf's last edge is a bridge and always in
+// the tree. What remains is the 2-core. With k = 1 that is one cycle and
+// its heaviest edge is dropped. In general the degree-2 chains between
+// branch vertices (degree >= 3) keep all but their heaviest edge, and
+// Kruskal over those at most 3(k - 1) heaviest edges settles the rest.
+int almostTreeMST(int V, const GraphEdge *edges, int E, int *tree) {
+    int *degree = (int *)calloc(V > 0 ? V : 1, sizeof(int));
+    int *incident = (int *)calloc(V > 0 ? V : 1, sizeof(int));  // XOR of the live edges at v
+    char *state = (char *)calloc(E > 0 ? E : 1, 1);  // 0 core, 1 peeled or loop, 2 walked
+    for (int e = 0; e < E; e++) {
+        if (edges[e].src == edges[e].dest) {
+            state[e] = 1;
+            continue;
+        }
+        degree[edges[e].src]++;
+        degree[edges[e].dest]++;
+        incident[edges[e].src] ^= e;
+        incident[edges[e].dest] ^= e;
+    }
+
+    // Peel leaves until only the 2-core is left. A leaf's XOR is its last
+    // edge, so no adjacency lists are needed yet.
+    int treeSize = 0, head = 0, tail = 0;
+    int *queue = (int *)malloc(sizeof(int) * (V > 0 ? V : 1));
+    for (int v = 0; v < V; v++)
+        if (degree[v] == 1)
+            queue[tail++] = v;
+    while (head < tail) {
+        int v = queue[head++];
+        if (degree[v] != 1) continue;
+        int e = incident[v];
+        state[e] = 1;
+        tree[treeSize++] = e;
+        degree[v] = 0;
+        int u = otherEnd(edges, e, v);
+        incident[u] ^= e;
+        if (--degree[u] == 1)
+            queue[tail++] = u;
+    }
+    free(queue);
+    free(incident);
+
+    // Adjacency of the core, in one IntList: the edges at v are
+    // arcs.data[start[v] .. start[v + 1])
+    int *start = (int *)malloc(sizeof(int) * (V + 1));
+    start[0] = 0;
+    for (int v = 0; v < V; v++)
+        start[v + 1] = start[v] + degree[v];
+    IntList arcs;
+    initList(&arcs);
+    reserve(&arcs, start[V]);
+    arcs.size = start[V];
+    // Fill each row back to front; start[v] ends up at the row's first slot
+    for (int v = 0; v < V; v++)
+        start[v] = start[v + 1];
+    for (int e = E - 1; e >= 0; e--) {
+        if (state[e]) continue;
+        arcs.data[--start[edges[e].src]] = e;
+        arcs.data[--start[edges[e].dest]] = e;
+    }
+
+    // Contract every chain that leaves a branch vertex to its heaviest edge
+    IntList chainEdge, chainEnds;
+    initList(&chainEdge);
+    initList(&chainEnds);
+    for (int v = 0; v < V; v++) {
+        if (degree[v] < 3) continue;
+        for (int i = start[v]; i < start[v + 1]; i++) {
+            int e = arcs.data[i], end;
+            if (state[e] != 0) continue;
+            insert(&chainEdge, walkChain(&arcs, start, edges, degree, state, v, e, &end, tree, &treeSize));
+            insert(&chainEnds, v);
+            insert(&chainEnds, end);
+        }
+    }
+    // Core edges still unwalked lie on cycles without a branch vertex
+    for (int e = 0; e < E; e++) {
+        int end;
+        if (state[e] == 0)
+            walkChain(&arcs, start, edges, degree, state, edges[e].src, e, &end, tree, &treeSize);
+    }
+
+    // Kruskal over the contracted chains
+    int chains = chainEdge.size;
+    if (chains > 0) {
+        int64_t *keys = (int64_t *)malloc(sizeof(int64_t) * chains);
+        int *order = (int *)malloc(sizeof(int) * chains);
+        for (int i = 0; i < chains; i++)
+            keys[i] = (int64_t)edges[chainEdge.data[i]].weight * ((int64_t)1 << 32) + chainEdge.data[i];
+        radixSortOrder64(keys, chains, order);
+        DSU *sets = createDSU(V);
+        for (int i = 0; i < chains; i++) {
+            int c = order[i];
+            if (dsuUnion(sets, chainEnds.data[2 * c], chainEnds.data[2 * c + 1]))
+                tree[treeSize++] = chainEdge.data[c];
+        }
+        freeDSU(sets);
+        free(keys);
+        free(order);
+    }
+
+    freeList(&chainEdge);
+    freeList(&chainEnds);
+    freeList(&arcs);
+    free(start);
+    free(degree);
+    free(state);
+    return treeSize;
+}
+
+// Print the MST of the graph in path, text or binary
+int runGraphFile(const char *path) {
+    MappedGraph file;
+    if (!openGraphFile(path, &file)) {
+        fprintf(stderr, "Could not read a graph from %s\n", path);
+        return 1;
+    }
+    int *tree = (int *)malloc(sizeof(int) * (file.V > 0 ? file.V : 1));
+    int size = almostTreeMST(file.V, file.edges, file.E, tree);
+    long long weight = 0;
+    for (int i = 0; i < size; i++)
+        weight += file.edges[tree[i]].weight;
+    if (size < file.V - 1)
+        printf("Graph is not connected: spanning forest of %d edges, weight %lld\n", size, weight);
+    else
+        printf("MST: %d edges (%d extra edges dropped), weight %lld\n", size, file.E - size, weight);
+    free(tree);
+    closeGraphFile(&file);
+    return 0;
+}
+
+#ifndef MST_LIBRARY_ONLY
+// Check every scan kernel this CPU supports against the scalar one on
+// random arrays of every length up to 300 and at every alignment
+static int selfTest(void) {
+    const IntScanKernels *kernels[4];
+    int count = intScanAvailable(kernels), failures = 0;
+    int *buffer = (int *)malloc(sizeof(int) * 320);
+    unsigned seed = 3050;
+    for (int n = 0; n <= 300; n++) {
+        for (int offset = 0; offset < 16; offset += 3) {
+            int *data = buffer + offset;
+            for (int i = 0; i < n; i++) {
+                seed = seed * 1103515245u + 12345u;
+                data[i] = (int)(seed >> 8) % 64 - 32;
+            }
+            if (n > 0 && n % 7 == 0) data[n - 1] = 2147483647;
+            if (n > 0 && n % 5 == 0) data[0] = -2147483647 - 1;
+            for (int v = -33; v <= 33; v += 11) {
+                for (int k = 1; k < count; k++) {
+                    if ((n > 0 && kernels[k]->max(data, n) != scalarMax(data, n)) ||
+                        kernels[k]->findFirst(data, n, v) != scalarFindFirst(data, n, v) ||
+                        kernels[k]->count(data, n, v) != scalarCount(data, n, v)) {
+                        printf("%s kernel mismatch: n=%d offset=%d value=%d\n", kernels[k]->name, n, offset, v);
+                        failures++;
+                    }
+                }
+            }
+        }
+    }
+    free(buffer);
+    for (int k = 0; k < count; k++)
+        printf("%s%s", k ? " " : "Kernels tested: ", kernels[k]->name);
+    printf("\nSelected: %s, %s\n", intScanKernels()->name, failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
 }
 
-int main() {
+int main(int argc, char **argv) {
+    if (argc > 1 && strcmp(argv[1], "--selftest") == 0)
+        return selfTest();
+    if (argc > 1)
+        return runGraphFile(argv[1]);
+
     IntList list;
     initList(&list);
 
@@ -107,6 +820,7 @@ int main() {
 
     printf("Index 1: %d\n", get(&list, 1)); // 5
     printf("Max: %d\n", findMax(&list));   // 30
+    printf("Count of 5: %d\n", countOf(&list, 5)); // 1
 
     sortAscending(&list);
     printList(&list); // 5 10 30
@@ -114,9 +828,54 @@ int main() {
     sortDescending(&list);
     printList(&list); // 30 10 5
 
+    int more[] = {7, 5, 40, 7};
+    insertMany(&list, more, 4);
+    printList(&list); // 30 10 5 7 5 40 7
+
+    int drop[] = {5, 7};
+    printf("Removed: %d\n", removeMany(&list, drop, 2)); // 4
+    printList(&list); // 30 10 40
+
     clear(&list);
     printf("Empty? %s\n", isEmpty(&list) ? "Yes" : "No");
 
     freeList(&list);
+
+    // The same operations on the tree variant, which keeps values sorted
+    IntList tree;
+    initListKind(&tree, LIST_TREE);
+
+    insert(&tree, 10);
+    insert(&tree, 20);
+    insert(&tree, 5);
+    insert(&tree, 30);
+
+    printList(&tree); // 5 10 20 30
+
+    removeItem(&tree, 20);
+    printList(&tree); // 5 10 30
+
+    printf("Index 1: %d\n", get(&tree, 1));         // 10
+    printf("Max: %d\n", findMax(&tree));            // 30
+    printf("Rank of 30: %d\n", rankOf(&tree, 30));  // 2
+    printf("2nd smallest: %d\n", kthSmallest(&tree, 1)); // 10
+
+    sortDescending(&tree);
+    printList(&tree); // 30 10 5
+
+    clear(&tree);
+    printf("Empty? %s\n", isEmpty(&tree) ? "Yes" : "No");
+
+    freeList(&tree);
+
+    // MST of an almost-tree: the cycle 0-1-2-3 with a tail 3-4
+    GraphEdge graph[] = {{0, 1, 4}, {1, 2, 1}, {2, 3, 3}, {3, 0, 2}, {3, 4, 5}};
+    int mst[4];
+    int mstSize = almostTreeMST(5, graph, 5, mst);
+    printf("Almost-tree MST:");
+    for (int i = 0; i < mstSize; i++)
+        printf(" %d-%d(%d)", graph[mst[i]].src, graph[mst[i]].dest, graph[mst[i]].weight);
+    printf("\n"); // 3-4(5) 1-2(1) 2-3(3) 3-0(2), dropping 0-1(4)
     return 0;
 }
+#endif // MST_LIBRARY_ONLY
@@ -1,94 +1,520 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
 
-#define MAXV 1000
-#define MAXE 10000
+#include "../common/csr_graph.h"
+#include "../common/radix_sort.h"
+#include "../common/dsu.h"
+#include "../common/edge_list_text.h"
+#include "../common/graph_file.h"
+#include "../common/mst_stats.h"
+#include "../common/external_sort.h"
 
-typedef struct {
-    int u, v, w;
-} Edge;
+GraphEdge *edges;
+int numVertices, numEdges;
+
+int isConnected(int limit) {
+    DSU *sets = createDSU(numVertices);
+    for (int i = 0; i < numEdges; i++) {
+        if (edges[i].weight > limit) break;
+        STAT_INC(edgesScanned);
+        dsuUnion(sets, edges[i].src, edges[i].dest);
+    }
+
+    int connected = sets->sets == 1;
+    freeDSU(sets);
+    return connected;
+}
+
+// Add sorted edges from *next on while their weight is at most limit
+void addEdgesUpTo(DSU *sets, int *next, int limit) {
+    for (; *next < numEdges && edges[*next].weight <= limit; (*next)++) {
+        STAT_INC(edgesScanned);
+        dsuUnion(sets, edges[*next].src, edges[*next].dest);
+    }
+}
+
+// Binary search over the sorted weights. Edges below the search window
+// are known to be needed, so they stay in the DSU; each probe adds the
+// window's light part under a checkpoint and keeps it only if the graph is
+// still disconnected, otherwise rolls it back. Every edge is committed at
+// most once and each probe only touches its own part of the window.
+int computeBST() {
+    STAT_TIMER_START(sortTimer);
+    sortGraphEdgesByWeight(edges, numEdges);
+    STAT_TIMER_STOP(sortTimer, "computeBST.sort");
+
+    STAT_TIMER_START(searchTimer);
+    DSU *sets = createDSU(numVertices);
+    int left = 0, right = numEdges - 1, ans = -1;
+    int committed = 0;
+    while (left <= right) {
+        int mid = (left + right) / 2;
+        int next = committed;
+        dsuCheckpoint(sets);
+        addEdgesUpTo(sets, &next, edges[mid].weight);
+        if (sets->sets == 1) {
+            ans = edges[mid].weight;
+            right = mid - 1;
+            dsuRollback(sets);
+        } else {
+            left = mid + 1;
+            committed = next;
+            dsuCommit(sets);
+        }
+    }
+    freeDSU(sets);
+    STAT_TIMER_STOP(searchTimer, "computeBST.search");
+
+    return ans;
+}
 
 typedef struct {
-    int parent, rank;
-} Subset;
+    int spanning;       // 1 if a spanning tree exists; one vertex spans itself with no edges
+    int weight;         // Bottleneck weight, only meaningful when size > 0
+    GraphEdge *edges;   // Edges of a bottleneck spanning tree
+    int size;
+} BottleneckTree;
 
-Edge edges[MAXE];
-int numVertices, numEdges;
+// Print the bottleneck weight, or why there is none
+void printBottleneck(const BottleneckTree *bst) {
+    if (!bst->spanning)
+        printf("No spanning tree exists\n");
+    else if (bst->size == 0)
+        printf("Bottleneck weight: none (the spanning tree has no edges)\n");
+    else
+        printf("Bottleneck weight: %d\n", bst->weight);
+}
+
+// Edge of the contracted graph: endpoints are component labels,
+// id indexes the original edge list
+typedef struct {
+    int u, v, id;
+} WorkEdge;
 
-int cmpEdge(const void *a, const void *b) {
-    return ((Edge*)a)->w - ((Edge*)b)->w;
+static int workLess(const WorkEdge *a, const WorkEdge *b) {
+    int wa = edges[a->id].weight, wb = edges[b->id].weight;
+    return wa < wb || (wa == wb && a->id < b->id);
 }
 
-int find(Subset subsets[], int i) {
-    if (subsets[i].parent != i)
-        subsets[i].parent = find(subsets, subsets[i].parent);
-    return subsets[i].parent;
+// Rearrange work so that work[k] holds the (k+1)-th lightest edge, with
+// lighter edges before it and heavier ones after it. Expected O(m).
+static void selectKth(WorkEdge *work, int m, int k, uint32_t *seed) {
+    int lo = 0, hi = m - 1;
+    while (lo < hi) {
+        *seed ^= *seed << 13;
+        *seed ^= *seed >> 17;
+        *seed ^= *seed << 5;
+        WorkEdge pivot = work[lo + (int)(*seed % (uint32_t)(hi - lo + 1))];
+
+        // Three-way split: [lo, lt) lighter, [lt, gt] pivot, (gt, hi] heavier
+        int lt = lo, i = lo, gt = hi;
+        while (i <= gt) {
+            if (workLess(&work[i], &pivot)) {
+                WorkEdge t = work[lt]; work[lt++] = work[i]; work[i++] = t;
+            } else if (workLess(&pivot, &work[i])) {
+                WorkEdge t = work[gt]; work[gt--] = work[i]; work[i] = t;
+            } else {
+                i++;
+            }
+        }
+        if (k < lt) hi = lt - 1;
+        else if (k > gt) lo = gt + 1;
+        else return;
+    }
 }
 
-void unionSets(Subset subsets[], int x, int y) {
-    int xroot = find(subsets, x);
-    int yroot = find(subsets, y);
-    if (xroot == yroot) return;
-    if (subsets[xroot].rank < subsets[yroot].rank)
-        subsets[xroot].parent = yroot;
-    else if (subsets[xroot].rank > subsets[yroot].rank)
-        subsets[yroot].parent = xroot;
-    else {
-        subsets[yroot].parent = xroot;
-        subsets[xroot].rank++;
+// Camerini's algorithm: split the edges at the median weight. If the light
+// half connects the graph the heavy half is irrelevant; otherwise the light
+// half's spanning forest is part of the answer, its components are
+// contracted and the search continues on the heavy half. Every round halves
+// the edge count, so the expected total work is O(V + E).
+BottleneckTree computeBSTCamerini() {
+    STAT_TIMER_START(timer);
+    BottleneckTree result = {0, -1, NULL, 0};
+    result.edges = (GraphEdge *)malloc((numVertices > 1 ? numVertices - 1 : 1) * sizeof(GraphEdge));
+
+    WorkEdge *work = (WorkEdge *)malloc((numEdges > 0 ? numEdges : 1) * sizeof(WorkEdge));
+    int m = 0;
+    for (int i = 0; i < numEdges; i++) {
+        if (edges[i].src == edges[i].dest) continue;
+        work[m].u = edges[i].src;
+        work[m].v = edges[i].dest;
+        work[m].id = i;
+        m++;
     }
+
+    int n = numVertices;
+    DSU *sets = createDSU(n);
+    int *label = (int *)malloc((n > 0 ? n : 1) * sizeof(int));
+    int *joined = (int *)malloc((m > 0 ? m : 1) * sizeof(int));
+    STAT_ADD(bytesAllocated, m * (sizeof(WorkEdge) + sizeof(int)) + n * sizeof(int));
+    uint32_t seed = 2463534242u;
+
+    while (n > 1) {
+        // Fewer than n - 1 edges can never connect n vertices
+        if (m < n - 1) break;
+
+        int light = (m + 1) / 2;
+        selectKth(work, m, light - 1, &seed);
+
+        dsuReset(sets, n);
+        int components = n, numJoined = 0;
+        STAT_ADD(edgesScanned, m);
+        for (int i = 0; i < light; i++) {
+            if (dsuUnion(sets, work[i].u, work[i].v)) {
+                joined[numJoined++] = work[i].id;
+                components--;
+            }
+        }
+
+        if (components == 1 && light < m) {
+            // The light half suffices: drop the heavy half
+            m = light;
+            continue;
+        }
+
+        // Keep the light spanning forest and contract its components
+        for (int i = 0; i < numJoined; i++)
+            result.edges[result.size++] = edges[joined[i]];
+        if (components == 1) {
+            n = 1;
+            break;
+        }
+
+        int next = 0;
+        for (int i = 0; i < n; i++)
+            if (dsuFind(sets, i) == i)
+                label[i] = next++;
+        int heavy = 0;
+        for (int i = light; i < m; i++) {
+            int cu = label[dsuFind(sets, work[i].u)];
+            int cv = label[dsuFind(sets, work[i].v)];
+            if (cu == cv) continue;
+            work[heavy].u = cu;
+            work[heavy].v = cv;
+            work[heavy].id = work[i].id;
+            heavy++;
+        }
+        n = components;
+        m = heavy;
+    }
+
+    // An empty graph has nothing to span; a single vertex needs no edges
+    if (n <= 1 && numVertices > 0) {
+        result.spanning = 1;
+        for (int i = 0; i < result.size; i++)
+            if (i == 0 || result.edges[i].weight > result.weight)
+                result.weight = result.edges[i].weight;
+    } else {
+        result.size = 0;
+    }
+
+    free(work);
+    freeDSU(sets);
+    free(label);
+    free(joined);
+    STAT_TIMER_STOP(timer, "computeBSTCamerini");
+    return result;
 }
 
-int isConnected(int limit) {
-    Subset subsets[MAXV];
-    for (int i = 0; i < numVertices; i++) {
-        subsets[i].parent = i;
-        subsets[i].rank = 0;
+// Bottleneck spanning tree of a graph file too large for memory. Kruskal
+// over the externally sorted edges builds an MST, and an MST is a
+// bottleneck spanning tree; the edge that completes it sets the weight.
+// Only the DSU and the tree are held in memory. Returns 0 if the file
+// cannot be read; bst->spanning is 0 when no spanning tree exists.
+int externalComputeBST(const char *path, const ExternalOptions *opts, BottleneckTree *bst, ExternalIOStats *io) {
+    ExternalEdgeSort sorted;
+    bst->spanning = 0;
+    bst->weight = -1;
+    bst->size = 0;
+    bst->edges = NULL;
+    if (!externalSortOpen(path, opts, &sorted)) {
+        *io = sorted.stats;
+        externalSortClose(&sorted);
+        return 0;
     }
 
-    int count = 0;
-    for (int i = 0; i < numEdges; i++) {
-        if (edges[i].w > limit) break;
-        int u = edges[i].u;
-        int v = edges[i].v;
-        if (find(subsets, u) != find(subsets, v)) {
-            unionSets(subsets, u, v);
-            count++;
+    int V = sorted.V;
+    bst->edges = (GraphEdge *)malloc((V > 1 ? V - 1 : 1) * sizeof(GraphEdge));
+    DSU *sets = createDSU(V);
+    GraphEdge e;
+    while (bst->size < V - 1 && externalSortNext(&sorted, &e)) {
+        STAT_INC(edgesScanned);
+        if (dsuUnion(sets, e.src, e.dest)) {
+            bst->edges[bst->size++] = e;
+            bst->weight = e.weight;
         }
     }
+    freeDSU(sets);
+    if (V > 0 && bst->size == V - 1) {
+        bst->spanning = 1;
+    } else {
+        bst->size = 0;
+        bst->weight = -1;
+    }
 
-    return count == numVertices - 1;
+    int ok = !externalSortFailed(&sorted);
+    *io = sorted.stats;
+    externalSortClose(&sorted);
+    return ok;
 }
 
-int computeBST() {
-    qsort(edges, numEdges, sizeof(Edge), cmpEdge);
+// Kruskal reconstruction tree: leaves are the vertices, and every union
+// Kruskal performs adds an internal node, weighted by the joining edge,
+// above the two trees it merges. The minimax edge weight between s and t
+// is the weight of their lowest common ancestor, found by binary lifting.
+typedef struct {
+    int numNodes;   // numVertices leaves plus one node per union
+    int levels;     // Number of binary-lifting levels
+    int *depth;
+    int *weight;    // Joining edge weight of each internal node
+    int *up;        // up[k * numNodes + x]: 2^k-th ancestor of x, or the root itself
+} MinimaxTree;
 
-    int left = 0, right = numEdges - 1, ans = -1;
-    while (left <= right) {
-        int mid = (left + right) / 2;
-        if (isConnected(edges[mid].w)) {
-            ans = edges[mid].w;
-            right = mid - 1;
-        } else {
-            left = mid + 1;
+// Build the tree from the global edge list, which must already be sorted
+// by weight. O(E α(V) + V log V).
+MinimaxTree *buildMinimaxTree() {
+    STAT_TIMER_START(timer);
+    int V = numVertices;
+    MinimaxTree *tree = (MinimaxTree *)malloc(sizeof(MinimaxTree));
+    int maxNodes = V > 0 ? 2 * V - 1 : 1;
+    int *parent = (int *)malloc(maxNodes * sizeof(int));
+    tree->weight = (int *)malloc(maxNodes * sizeof(int));
+    tree->depth = (int *)malloc(maxNodes * sizeof(int));
+
+    // top[r] is the tree node standing for the DSU set rooted at r
+    DSU *sets = createDSU(V);
+    int *top = (int *)malloc((V > 0 ? V : 1) * sizeof(int));
+    for (int v = 0; v < V; v++) {
+        top[v] = v;
+        parent[v] = v;
+        tree->weight[v] = 0;
+    }
+    int n = V;
+    for (int i = 0; i < numEdges && n < maxNodes; i++) {
+        STAT_INC(edgesScanned);
+        int a = dsuFind(sets, edges[i].src);
+        int b = dsuFind(sets, edges[i].dest);
+        if (a == b) continue;
+        parent[top[a]] = n;
+        parent[top[b]] = n;
+        parent[n] = n;
+        tree->weight[n] = edges[i].weight;
+        dsuUnion(sets, a, b);
+        top[dsuFind(sets, a)] = n;
+        n++;
+    }
+    freeDSU(sets);
+    free(top);
+
+    // Parents are created after their children, so a downward sweep sets depths
+    for (int x = n - 1; x >= 0; x--)
+        tree->depth[x] = parent[x] == x ? 0 : tree->depth[parent[x]] + 1;
+
+    tree->numNodes = n;
+    tree->levels = 1;
+    while ((1 << tree->levels) < n)
+        tree->levels++;
+    tree->up = (int *)malloc((size_t)tree->levels * (n > 0 ? n : 1) * sizeof(int));
+    STAT_ADD(bytesAllocated, (size_t)tree->levels * n * sizeof(int) + 3 * (size_t)maxNodes * sizeof(int));
+    memcpy(tree->up, parent, n * sizeof(int));
+    for (int k = 1; k < tree->levels; k++) {
+        int *prev = tree->up + (size_t)(k - 1) * n;
+        int *cur = tree->up + (size_t)k * n;
+        for (int x = 0; x < n; x++)
+            cur[x] = prev[prev[x]];
+    }
+    free(parent);
+    STAT_TIMER_STOP(timer, "buildMinimaxTree");
+    return tree;
+}
+
+void freeMinimaxTree(MinimaxTree *tree) {
+    free(tree->depth);
+    free(tree->weight);
+    free(tree->up);
+    free(tree);
+}
+
+// Result of a minimax query
+#define MINIMAX_DISCONNECTED 0
+#define MINIMAX_PATH 1          // *weight holds the minimax edge weight
+#define MINIMAX_SAME_VERTEX 2   // s == t: the empty path, which has no edges
+
+// Smallest possible maximum edge weight over all s-t paths, in O(log V)
+int minimaxQuery(const MinimaxTree *tree, int s, int t, int *weight) {
+    if (s == t) return MINIMAX_SAME_VERTEX;
+    int n = tree->numNodes;
+    const int *up = tree->up;
+    if (tree->depth[s] < tree->depth[t]) {
+        int tmp = s; s = t; t = tmp;
+    }
+    int diff = tree->depth[s] - tree->depth[t];
+    for (int k = 0; diff > 0; k++, diff >>= 1)
+        if (diff & 1)
+            s = up[(size_t)k * n + s];
+    if (s != t) {
+        for (int k = tree->levels - 1; k >= 0; k--) {
+            if (up[(size_t)k * n + s] != up[(size_t)k * n + t]) {
+                s = up[(size_t)k * n + s];
+                t = up[(size_t)k * n + t];
+            }
         }
+        // Two different roots: s and t lie in different components
+        if (up[s] != up[t]) return MINIMAX_DISCONNECTED;
+        s = up[s];
     }
+    *weight = tree->weight[s];
+    return MINIMAX_PATH;
+}
 
-    return ans;
+// Read "s t" pairs, one per line, until the end of the file
+int loadQueries(const char *path, int **pairs, int *count) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return 0;
+    size_t len;
+    const char *map = mapTextFile(fd, &len);
+    char *buf = map ? NULL : readAllText(fd, &len);
+    close(fd);
+
+    TextCursor c = {map ? map : buf, (map ? map : buf) + len};
+    int capacity = 1024, ok = 1, s, t;
+    *pairs = (int *)malloc(2 * capacity * sizeof(int));
+    *count = 0;
+    while (nextInt(&c, &s)) {
+        if (!nextInt(&c, &t) || s < 0 || s >= numVertices || t < 0 || t >= numVertices) {
+            ok = 0;
+            break;
+        }
+        if (*count == capacity) {
+            capacity *= 2;
+            *pairs = (int *)realloc(*pairs, 2 * capacity * sizeof(int));
+        }
+        (*pairs)[2 * *count] = s;
+        (*pairs)[2 * *count + 1] = t;
+        (*count)++;
+    }
+    if (map) munmap((void *)map, len);
+    free(buf);
+    if (!ok) free(*pairs);
+    return ok;
 }
 
-int main() {
-    scanf("%d %d", &numVertices, &numEdges);
-    for (int i = 0; i < numEdges; i++) {
-        scanf("%d %d %d", &edges[i].u, &edges[i].v, &edges[i].w);
+// Answer a batch of minimax queries: "s t w" per pair, "s t empty" when
+// s == t (the path has no edges), or "s t none" when they are disconnected
+int runQueries(const char *path) {
+    int *pairs, count;
+    if (!loadQueries(path, &pairs, &count)) {
+        fprintf(stderr, "Could not read queries from %s\n", path);
+        return 1;
     }
 
-    int bottleneck = computeBST();
-    if (bottleneck == -1) {
-        printf("No spanning tree exists\n");
+    sortGraphEdgesByWeight(edges, numEdges);
+    MinimaxTree *tree = buildMinimaxTree();
+
+    // The tree spans the graph once it has V - 1 internal nodes; the last
+    // one joins along the bottleneck edge
+    BottleneckTree bst = {0, -1, NULL, 0};
+    if (numVertices > 0 && tree->numNodes == 2 * numVertices - 1) {
+        bst.spanning = 1;
+        bst.size = numVertices - 1;
+        if (bst.size > 0)
+            bst.weight = tree->weight[tree->numNodes - 1];
+    }
+    printBottleneck(&bst);
+
+    STAT_TIMER_START(timer);
+    for (int i = 0; i < count; i++) {
+        int s = pairs[2 * i], t = pairs[2 * i + 1], w;
+        int found = minimaxQuery(tree, s, t, &w);
+        if (found == MINIMAX_PATH)
+            printf("%d %d %d\n", s, t, w);
+        else if (found == MINIMAX_SAME_VERTEX)
+            printf("%d %d empty\n", s, t);
+        else
+            printf("%d %d none\n", s, t);
+    }
+    STAT_TIMER_STOP(timer, "minimaxQuery");
+
+    freeMinimaxTree(tree);
+    free(pairs);
+    return 0;
+}
+
+#ifndef MST_LIBRARY_ONLY
+// Reads the graph file named on the command line, binary or text, or a
+// text edge list ("V E" followed by E lines of "u v w") from stdin.
+// --queries <file> answers the minimax "s t" pairs in file instead of
+// printing only the bottleneck weight.
+// --external [--memory-mb n] [--temp-dir dir] streams the edges through
+// an on-disk sort instead of loading them.
+// --stats dumps the operation counters as JSON on stderr at exit
+int main(int argc, char **argv) {
+    int stats = mstStatsTakeFlag(&argc, argv);
+    ExternalOptions externalOpts;
+    int external = externalTakeOptions(&argc, argv, &externalOpts);
+    const char *graphPath = NULL, *queryPath = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--queries") == 0 && i + 1 < argc)
+            queryPath = argv[++i];
+        else
+            graphPath = argv[i];
+    }
+
+    if ((external && queryPath) || externalOpts.invalid) {
+        fprintf(stderr, "Usage: %s [--external [--memory-mb n] [--temp-dir dir] | --queries pairs.txt] [graph]\n", argv[0]);
+        return 2;
+    }
+
+    if (external) {
+        BottleneckTree bst;
+        ExternalIOStats io;
+        if (!externalComputeBST(graphPath ? graphPath : "-", &externalOpts, &bst, &io)) {
+            fprintf(stderr, "Could not sort the edges of %s\n", graphPath ? graphPath : "stdin");
+            free(bst.edges);
+            return 1;
+        }
+        printBottleneck(&bst);
+        externalPrintIOStats(stdout, &io);
+        free(bst.edges);
+        if (stats)
+            mstStatsPrintJSON(stderr);
+        return 0;
+    }
+
+    MappedGraph file = {0};
+    int ok;
+    if (graphPath) {
+        ok = openGraphFile(graphPath, &file);
+        numVertices = file.V;
+        numEdges = file.E;
+        edges = file.edges;
     } else {
-        printf("Bottleneck weight: %d\n", bottleneck);
+        ok = loadEdgeListFd(STDIN_FILENO, &numVertices, &numEdges, &edges);
+        file.ownedEdges = edges;
+    }
+    if (!ok) {
+        fprintf(stderr, "Could not read a graph from %s\n", graphPath ? graphPath : "stdin");
+        return 1;
     }
 
+    if (queryPath) {
+        int status = runQueries(queryPath);
+        closeGraphFile(&file);
+        if (stats)
+            mstStatsPrintJSON(stderr);
+        return status;
+    }
+
+    BottleneckTree bst = computeBSTCamerini();
+    printBottleneck(&bst);
+    free(bst.edges);
+    closeGraphFile(&file);
+
+    if (stats)
+        mstStatsPrintJSON(stderr);
     return 0;
 }
+#endif // MST_LIBRARY_ONLY